@@ -36,19 +36,41 @@ config_pri_source_group1 {
         $$quote($$BASEDIR/src/qdropbox/Logger.cpp) \
         $$quote($$BASEDIR/src/qdropbox/QDropbox.cpp) \
         $$quote($$BASEDIR/src/qdropbox/QDropboxAccessLevel.cpp) \
+        $$quote($$BASEDIR/src/qdropbox/QDropboxAccountPool.cpp) \
         $$quote($$BASEDIR/src/qdropbox/QDropboxAclUpdatePolicy.cpp) \
+        $$quote($$BASEDIR/src/qdropbox/QDropboxAtomicFile.cpp) \
+        $$quote($$BASEDIR/src/qdropbox/QDropboxBlockCopy.cpp) \
+        $$quote($$BASEDIR/src/qdropbox/QDropboxBlockStore.cpp) \
+        $$quote($$BASEDIR/src/qdropbox/QDropboxConcurrentClient.cpp) \
+        $$quote($$BASEDIR/src/qdropbox/QDropboxContentHash.cpp) \
+        $$quote($$BASEDIR/src/qdropbox/QDropboxDeltaSync.cpp) \
+        $$quote($$BASEDIR/src/qdropbox/QDropboxDirectoryDownload.cpp) \
+        $$quote($$BASEDIR/src/qdropbox/QDropboxDirectoryUpload.cpp) \
         $$quote($$BASEDIR/src/qdropbox/QDropboxFile.cpp) \
         $$quote($$BASEDIR/src/qdropbox/QDropboxFolderAction.cpp) \
         $$quote($$BASEDIR/src/qdropbox/QDropboxFolderMember.cpp) \
+        $$quote($$BASEDIR/src/qdropbox/QDropboxJobTracker.cpp) \
+        $$quote($$BASEDIR/src/qdropbox/QDropboxLocalScanner.cpp) \
         $$quote($$BASEDIR/src/qdropbox/QDropboxMember.cpp) \
         $$quote($$BASEDIR/src/qdropbox/QDropboxMemberPolicy.cpp) \
+        $$quote($$BASEDIR/src/qdropbox/QDropboxPathTree.cpp) \
         $$quote($$BASEDIR/src/qdropbox/QDropboxPendingUpload.cpp) \
+        $$quote($$BASEDIR/src/qdropbox/QDropboxRateLimiter.cpp) \
+        $$quote($$BASEDIR/src/qdropbox/QDropboxRequest.cpp) \
+        $$quote($$BASEDIR/src/qdropbox/QDropboxSearchIndex.cpp) \
+        $$quote($$BASEDIR/src/qdropbox/QDropboxSessionUpload.cpp) \
+        $$quote($$BASEDIR/src/qdropbox/QDropboxShardedListing.cpp) \
         $$quote($$BASEDIR/src/qdropbox/QDropboxSharedLinkPolicy.cpp) \
         $$quote($$BASEDIR/src/qdropbox/QDropboxSpaceUsage.cpp) \
+        $$quote($$BASEDIR/src/qdropbox/QDropboxSyncEngine.cpp) \
         $$quote($$BASEDIR/src/qdropbox/QDropboxTag.cpp) \
         $$quote($$BASEDIR/src/qdropbox/QDropboxTempLink.cpp) \
+        $$quote($$BASEDIR/src/qdropbox/QDropboxThumbnailCache.cpp) \
+        $$quote($$BASEDIR/src/qdropbox/QDropboxThumbnailDecoder.cpp) \
         $$quote($$BASEDIR/src/qdropbox/QDropboxUpload.cpp) \
         $$quote($$BASEDIR/src/qdropbox/QDropboxViewerInfoPolicy.cpp) \
+        $$quote($$BASEDIR/src/qdropbox/QDropboxWorker.cpp) \
+        $$quote($$BASEDIR/src/qdropbox/QDropboxZipExtractor.cpp) \
         $$quote($$BASEDIR/src/qdropbox/SharedLink.cpp) \
         $$quote($$BASEDIR/src/qjson/json_parser.cc) \
         $$quote($$BASEDIR/src/qjson/json_scanner.cc) \
@@ -64,20 +86,42 @@ config_pri_source_group1 {
         $$quote($$BASEDIR/include/qdropbox/Logger.hpp) \
         $$quote($$BASEDIR/include/qdropbox/QDropbox.hpp) \
         $$quote($$BASEDIR/include/qdropbox/QDropboxAccessLevel.hpp) \
+        $$quote($$BASEDIR/include/qdropbox/QDropboxAccountPool.hpp) \
         $$quote($$BASEDIR/include/qdropbox/QDropboxAclUpdatePolicy.hpp) \
+        $$quote($$BASEDIR/include/qdropbox/QDropboxAtomicFile.hpp) \
+        $$quote($$BASEDIR/include/qdropbox/QDropboxBlockCopy.hpp) \
+        $$quote($$BASEDIR/include/qdropbox/QDropboxBlockStore.hpp) \
         $$quote($$BASEDIR/include/qdropbox/QDropboxCommon.hpp) \
+        $$quote($$BASEDIR/include/qdropbox/QDropboxConcurrentClient.hpp) \
+        $$quote($$BASEDIR/include/qdropbox/QDropboxContentHash.hpp) \
+        $$quote($$BASEDIR/include/qdropbox/QDropboxDeltaSync.hpp) \
+        $$quote($$BASEDIR/include/qdropbox/QDropboxDirectoryDownload.hpp) \
+        $$quote($$BASEDIR/include/qdropbox/QDropboxDirectoryUpload.hpp) \
         $$quote($$BASEDIR/include/qdropbox/QDropboxFile.hpp) \
         $$quote($$BASEDIR/include/qdropbox/QDropboxFolderAction.hpp) \
         $$quote($$BASEDIR/include/qdropbox/QDropboxFolderMember.hpp) \
+        $$quote($$BASEDIR/include/qdropbox/QDropboxJobTracker.hpp) \
+        $$quote($$BASEDIR/include/qdropbox/QDropboxLocalScanner.hpp) \
         $$quote($$BASEDIR/include/qdropbox/QDropboxMember.hpp) \
         $$quote($$BASEDIR/include/qdropbox/QDropboxMemberPolicy.hpp) \
+        $$quote($$BASEDIR/include/qdropbox/QDropboxPathTree.hpp) \
         $$quote($$BASEDIR/include/qdropbox/QDropboxPendingUpload.hpp) \
+        $$quote($$BASEDIR/include/qdropbox/QDropboxRateLimiter.hpp) \
+        $$quote($$BASEDIR/include/qdropbox/QDropboxRequest.hpp) \
+        $$quote($$BASEDIR/include/qdropbox/QDropboxSearchIndex.hpp) \
+        $$quote($$BASEDIR/include/qdropbox/QDropboxSessionUpload.hpp) \
+        $$quote($$BASEDIR/include/qdropbox/QDropboxShardedListing.hpp) \
         $$quote($$BASEDIR/include/qdropbox/QDropboxSharedLinkPolicy.hpp) \
         $$quote($$BASEDIR/include/qdropbox/QDropboxSpaceUsage.hpp) \
+        $$quote($$BASEDIR/include/qdropbox/QDropboxSyncEngine.hpp) \
         $$quote($$BASEDIR/include/qdropbox/QDropboxTag.hpp) \
         $$quote($$BASEDIR/include/qdropbox/QDropboxTempLink.hpp) \
+        $$quote($$BASEDIR/include/qdropbox/QDropboxThumbnailCache.hpp) \
+        $$quote($$BASEDIR/include/qdropbox/QDropboxThumbnailDecoder.hpp) \
         $$quote($$BASEDIR/include/qdropbox/QDropboxUpload.hpp) \
         $$quote($$BASEDIR/include/qdropbox/QDropboxViewerInfoPolicy.hpp) \
+        $$quote($$BASEDIR/include/qdropbox/QDropboxWorker.hpp) \
+        $$quote($$BASEDIR/include/qdropbox/QDropboxZipExtractor.hpp) \
         $$quote($$BASEDIR/include/qdropbox/SharedLink.hpp) \
         $$quote($$BASEDIR/include/qdropbox/qdropbox_global.hpp) \
         $$quote($$BASEDIR/src/qjson/FlexLexer.h) \
@@ -19,6 +19,9 @@
 #include <QFile>
 #include <QStringList>
 #include <QQueue>
+#include <QHash>
+#include <QMap>
+#include <QTimer>
 
 #include "QDropboxMember.hpp"
 #include "QDropboxFolderAction.hpp"
@@ -35,6 +38,10 @@
 #include "QDropboxSpaceUsage.hpp"
 #include "Logger.hpp"
 #include "QDropboxUpload.hpp"
+#include "QDropboxThumbnailCache.hpp"
+#include "QDropboxBlockStore.hpp"
+#include "QDropboxThumbnailDecoder.hpp"
+#include "QDropboxRequest.hpp"
 
 struct MoveEntry : public QObject {
     MoveEntry(const QString& fromPath, const QString& toPath, QObject* parent = 0) : QObject(parent) {
@@ -101,6 +108,68 @@ struct UnshareJobStatus {
     }
 };
 
+struct AsyncJobStatus {
+    enum Status {
+        InProgress,
+        Complete,
+        Failed
+    };
+
+    AsyncJobStatus() : status(InProgress) {}
+
+    Status status;
+    QString type;
+    QString asyncJobId;
+    QVariantMap result;
+    QVariantList entries;
+
+    QVariantMap toMap() const {
+        QVariantMap map;
+        map["status"] = (int) status;
+        map["type"] = type;
+        map["async_job_id"] = asyncJobId;
+        map["result"] = result;
+        map["entries"] = entries;
+        return map;
+    }
+
+    void fromMap(const QVariantMap& map) {
+        status = (Status) map.value("status").toInt();
+        type = map.value("type").toString();
+        asyncJobId = map.value("async_job_id").toString();
+        result = map.value("result").toMap();
+        entries = map.value("entries").toList();
+    }
+};
+
+struct UploadSessionEntry {
+    UploadSessionEntry() : offset(0), mode("add"), autorename(false), mute(false) {}
+
+    QString sessionId;
+    qint64 offset;
+    QString path;
+    QString mode;
+    bool autorename;
+    bool mute;
+
+    QVariantMap toMap() const {
+        QVariantMap cursor;
+        cursor["session_id"] = sessionId;
+        cursor["offset"] = offset;
+        QVariantMap commit;
+        commit["path"] = path;
+        commit["mode"] = mode;
+        commit["autorename"] = autorename;
+        commit["mute"] = mute;
+        QVariantMap map;
+        map["cursor"] = cursor;
+        map["commit"] = commit;
+        return map;
+    }
+};
+
+class QDropboxJobTracker;
+
 class QDropbox : public QObject {
     Q_OBJECT
 public:
@@ -132,54 +201,123 @@ public:
 
     QDropbox& setReadBufferSize(qint64 readBufferSize);
 
+    const int& getMaxBufferedPages() const;
+    QDropbox& setMaxBufferedPages(const int& maxBufferedPages);
+
+    const bool& isCoalesceRequests() const;
+    QDropbox& setCoalesceRequests(const bool& coalesceRequests);
+
+    QDropboxThumbnailCache* getThumbnailCache() const;
+    QDropbox& setThumbnailCache(QDropboxThumbnailCache* thumbnailCache);
+
+    QDropboxBlockStore* getBlockStore() const;
+    QDropbox& setBlockStore(QDropboxBlockStore* blockStore);
+
+    const bool& isThumbnailBatching() const;
+    QDropbox& setThumbnailBatching(const bool& thumbnailBatching);
+
+    int getThumbnailBatchWindow() const;
+    QDropbox& setThumbnailBatchWindow(const int& msec);
+
+    const QSize& getThumbnailScaledSize() const;
+    QDropbox& setThumbnailScaledSize(const QSize& thumbnailScaledSize);
+
+    QNetworkAccessManager* getNetworkAccessManager() const;
+    QDropbox& setNetworkAccessManager(QNetworkAccessManager* network);
+
+    int getKeepWarmInterval() const;
+    QDropbox& setKeepWarmInterval(const int& msec);
+
+    const bool& isHttp2Allowed() const;
+    QDropbox& setHttp2Allowed(const bool& http2Allowed);
+
+    int getMaxConnectionsPerHost(const QString& host = "") const;
+    QDropbox& setMaxConnectionsPerHost(const int& maxConnections);
+    QDropbox& setMaxConnectionsPerHost(const QString& host, const int& maxConnections);
+
+    const int& getRequestTimeout() const;
+    QDropbox& setRequestTimeout(const int& requestTimeout);
+
+    const int& getStallTimeout() const;
+    QDropbox& setStallTimeout(const int& stallTimeout);
+
+    const int& getMaxRetries() const;
+    QDropbox& setMaxRetries(const int& maxRetries);
+
+    double getRequestRate() const;
+    QDropbox& setRequestRate(const double& requestsPerSecond, const int& burst);
+
+    const bool& isWriteCombining() const;
+    QDropbox& setWriteCombining(const bool& writeCombining);
+
+    int getWriteCombineWindow() const;
+    QDropbox& setWriteCombineWindow(const int& msec);
+
     QString authUrl() const;
 
     // auth
-    void authTokenRevoke();
+    QDropboxRequest* authTokenRevoke();
 
     // files
-    void listFolder(const QString& path = "", const bool& includeMediaInfo = false, const bool& recursive = false,
+    QDropboxRequest* listFolder(const QString& path = "", const bool& includeMediaInfo = false, const bool& recursive = false,
                     const bool& includeDeleted = false, const bool& includeHasExplicitSharedMembers = false, const bool& includeMountedFolders = true,
                     const int& limit = 0, SharedLink sharedLink = SharedLink());
-    void listFolderContinue(const QString& cursor);
-    void listFolderLongPoll(const QString& cursor, const int& timeout = 30);
-    void createFolder(const QString& path, const bool& autorename = false);
-    void deleteFile(const QString& path);
-    void deleteBatch(const QStringList& paths);
-    void move(const QString& fromPath, const QString& toPath, const bool& allowSharedFolder = false, const bool& autorename = false, const bool& allowOwnershipTransfer = false);
-    void moveBatch(const QList<MoveEntry>& moveEntries, const bool& allowSharedFolder = false, const bool& autorename = false, const bool& allowOwnershipTransfer = false);
-    void rename(const QString& fromPath, const QString& toPath, const bool& allowSharedFolder = false, const bool& autorename = false, const bool& allowOwnershipTransfer = false);
-    void getThumbnail(const QString& path, const QString& size = "w128h128", const QString& format = "jpeg");
-    void download(const QString& path, const QString& rev = "");
-    void downloadZip(const QString& path, const QString& rev = "");
-    void upload(QFile* file, const QString& remotePath, const QString& mode = "add", const bool& autorename = true, const bool& mute = false);
-    void uploadSessionStart(const QString& remotePath, const QByteArray& data, const bool& close = false);
-    void uploadSessionAppend(const QString& sessionId, const QByteArray& data, const qint64& offset, const bool& close = false);
-    void uploadSessionFinish(const QString& sessionId, const QByteArray& data, const qint64& offset, const QString& path, const QString& mode = "add", const bool& autorename = false, const bool& mute = false);
-    void getTemporaryLink(const QString& path);
-    void saveUrl(const QString& path, const QString& url);
-    void getMetadata(const QString& path, const bool& includeMediaInfo = false, const bool& includeDeleted = false, const bool& includeHasExplicitSharedMembers = false);
+    QDropboxRequest* listFolderContinue(const QString& cursor);
+    QDropboxRequest* listFolderPaged(const QString& path = "", const bool& includeMediaInfo = false, const bool& recursive = false,
+                    const bool& includeDeleted = false, const int& limit = 0);
+    void cancelListFolderPaging(const int& pagingId);
+    QDropboxRequest* listFolderLongPoll(const QString& cursor, const int& timeout = 30);
+    QDropboxRequest* createFolder(const QString& path, const bool& autorename = false);
+    QDropboxRequest* deleteFile(const QString& path);
+    QDropboxRequest* deleteBatch(const QStringList& paths);
+    QDropboxRequest* move(const QString& fromPath, const QString& toPath, const bool& allowSharedFolder = false, const bool& autorename = false, const bool& allowOwnershipTransfer = false);
+    QDropboxRequest* moveBatch(const QList<MoveEntry>& moveEntries, const bool& allowSharedFolder = false, const bool& autorename = false, const bool& allowOwnershipTransfer = false);
+    QDropboxRequest* copy(const QString& fromPath, const QString& toPath, const bool& allowSharedFolder = false, const bool& autorename = false, const bool& allowOwnershipTransfer = false);
+    QDropboxRequest* copyBatch(const QList<MoveEntry>& copyEntries, const bool& autorename = false);
+    QDropboxRequest* rename(const QString& fromPath, const QString& toPath, const bool& allowSharedFolder = false, const bool& autorename = false, const bool& allowOwnershipTransfer = false);
+    QDropboxRequest* getThumbnail(const QString& path, const QString& size = "w128h128", const QString& format = "jpeg");
+    QList<QDropboxRequest*> getThumbnailBatch(const QStringList& paths, const QString& size = "w128h128", const QString& format = "jpeg");
+    void releaseThumbnail(QImage* thumbnail);
+    QDropboxRequest* download(const QString& path, const QString& rev = "");
+    QDropboxRequest* download(const QString& path, QIODevice* sink, const QString& rev = "");
+    QDropboxRequest* downloadFile(const QString& path, const QString& localPath, const QString& rev = "", const QString& contentHash = "");
+    QDropboxRequest* downloadZip(const QString& path, const QString& rev = "");
+    QDropboxRequest* downloadZip(const QString& path, QIODevice* device);
+    QDropboxRequest* upload(QFile* file, const QString& remotePath, const QString& mode = "add", const bool& autorename = true, const bool& mute = false);
+    QDropboxRequest* uploadSessionStart(const QString& remotePath, const QByteArray& data, const bool& close = false);
+    QDropboxRequest* uploadSessionAppend(const QString& sessionId, const QByteArray& data, const qint64& offset, const bool& close = false);
+    QDropboxRequest* uploadSessionFinish(const QString& sessionId, const QByteArray& data, const qint64& offset, const QString& path, const QString& mode = "add", const bool& autorename = false, const bool& mute = false);
+    QDropboxRequest* uploadSessionFinishBatch(const QList<UploadSessionEntry>& entries);
+    QDropboxRequest* getTemporaryLink(const QString& path);
+    QDropboxRequest* saveUrl(const QString& path, const QString& url);
+    QDropboxRequest* getMetadata(const QString& path, const bool& includeMediaInfo = false, const bool& includeDeleted = false, const bool& includeHasExplicitSharedMembers = false);
 
     // sharing
-    void addFolderMember(const QString& sharedFolderId, const QList<QDropboxMember>& members, const bool& quiet = false, const QString& customMessage = "");
-    void removeFolderMember(const QString& sharedFolderId, QDropboxMember& member, const bool& leaveACopy = false);
-    void updateFolderMember(const QString& sharedFolderId, QDropboxMember& member);
-    void listFolderMembers(const QString& sharedFolderId, const int& limit = 0);
-    void shareFolder(const QString& path, const bool& forceAsync = false, const QDropboxAclUpdatePolicy& aclUpdatePolicy = QDropboxAclUpdatePolicy(),
+    QDropboxRequest* addFolderMember(const QString& sharedFolderId, const QList<QDropboxMember>& members, const bool& quiet = false, const QString& customMessage = "");
+    QDropboxRequest* removeFolderMember(const QString& sharedFolderId, QDropboxMember& member, const bool& leaveACopy = false);
+    QDropboxRequest* updateFolderMember(const QString& sharedFolderId, QDropboxMember& member);
+    QDropboxRequest* listFolderMembers(const QString& sharedFolderId, const int& limit = 0);
+    QDropboxRequest* shareFolder(const QString& path, const bool& forceAsync = false, const QDropboxAclUpdatePolicy& aclUpdatePolicy = QDropboxAclUpdatePolicy(),
             const QDropboxMemberPolicy& memberPolicy = QDropboxMemberPolicy(),
             const QDropboxSharedLinkPolicy& sharedLinkPolicy = QDropboxSharedLinkPolicy(), const QDropboxViewerInfoPolicy& viewerInfoPolicy = QDropboxViewerInfoPolicy(),
             const QList<QDropboxFolderAction>& folderActions = QList<QDropboxFolderAction>()); // TODO: add LinkSettings!
-    void unshareFolder(const QString& sharedFolderId, const bool& leaveACopy = false);
-    void createSharedLink(const QString& path, const bool& shortUrl = false, const QDropboxPendingUpload& pendingUpload = QDropboxPendingUpload());
-    void revokeSharedLink(const QString& sharedLinkUrl);
-    void getSharedLinks(const QString& path = "");
-    void checkJobStatus(const QString& asyncJobId);
+    QDropboxRequest* unshareFolder(const QString& sharedFolderId, const bool& leaveACopy = false);
+    QDropboxRequest* createSharedLink(const QString& path, const bool& shortUrl = false, const QDropboxPendingUpload& pendingUpload = QDropboxPendingUpload());
+    QDropboxRequest* revokeSharedLink(const QString& sharedLinkUrl);
+    QDropboxRequest* getSharedLinks(const QString& path = "");
+    QDropboxRequest* checkJobStatus(const QString& asyncJobId);
+    QDropboxRequest* checkJob(const QString& type, const QString& asyncJobId);
+    QDropboxJobTracker* getJobTracker() const;
 
     // users
-    void getAccount(const QString& accountId);
-    void getAccountBatch(const QStringList& accountIds);
-    void getCurrentAccount();
-    void getSpaceUsage();
+    QDropboxRequest* getAccount(const QString& accountId);
+    QDropboxRequest* getAccountBatch(const QStringList& accountIds);
+    QDropboxRequest* getCurrentAccount();
+    QDropboxRequest* getSpaceUsage();
+
+public slots:
+    void flushWrites();
+    void warmUp();
 
 Q_SIGNALS:
     void accessTokenChanged(const QString& accessToken);
@@ -190,16 +328,23 @@ Q_SIGNALS:
     // files signals
     void listFolderLoaded(const QString& path, QList<QDropboxFile*>& files, const QString& cursor, const bool& hasMore);
     void listFolderContinueLoaded(QList<QDropboxFile*>& files, const QString& prevCursor, const QString& cursor, const bool& hasMore);
-    void listFolderLongPollFinished(const QString& cursor, const bool& changes);
+    void listFolderPageLoaded(const QString& path, QList<QDropboxFile*>& files, const QString& cursor, const bool& hasMore);
+    void listFolderPagingFinished(const QString& path, const QString& cursor);
+    void listFolderPagingFailed(const QString& path, QNetworkReply::NetworkError e, const QString& errorString);
+    void listFolderLongPollFinished(const QString& cursor, const bool& changes, const int& backoff = 0);
     void folderCreated(QDropboxFile* folder);
     void fileDeleted(QDropboxFile* folder);
     void deletedBatch(const QStringList& paths);
     void moved(QDropboxFile* file, const QString& fromPath, const QString& toPath);
     void movedBatch(const QList<MoveEntry>& moveEntries);
+    void copied(QDropboxFile* file, const QString& fromPath, const QString& toPath);
+    void copiedBatch(const QList<MoveEntry>& copyEntries);
     void renamed(QDropboxFile* file);
     void thumbnailLoaded(const QString& path, const QString& size, QImage* thumbnail);
+    void thumbnailFailed(const QString& path, const QString& size, QNetworkReply::NetworkError e, const QString& errorString);
     void downloadStarted(const QString& path);
     void downloaded(const QString& path, const QString& localPath);
+    void downloadStreamed(const QString& path, QIODevice* device);
     void downloadProgress(const QString& path, qint64 loaded, qint64 total);
     void uploadStarted(const QString& remotePath);
     void uploaded(QDropboxFile* file);
@@ -207,6 +352,7 @@ Q_SIGNALS:
     void uploadSessionStarted(const QString& remotePath, const QString& sessionId);
     void uploadSessionAppended(const QString& sessionId);
     void uploadSessionFinished(QDropboxFile* file);
+    void uploadSessionFinishedBatch(const QStringList& paths);
     void temporaryLinkLoaded(QDropboxTempLink* link);
     void urlSaved();
     void uploadFailed(const QString& reason);
@@ -223,6 +369,8 @@ Q_SIGNALS:
     void sharedLinkRevoked(const QString& sharedLinkUrl);
     void sharedLinksLoaded(const QList<SharedLink*>& links);
     void jobStatusChecked(const UnshareJobStatus& status);
+    void asyncJobLaunched(const QString& type, const QString& asyncJobId);
+    void asyncJobChecked(const AsyncJobStatus& status);
 
     // users signals
     void accountLoaded(Account* account);
@@ -241,27 +389,46 @@ private slots:
     // files slots
     void onListFolderLoaded();
     void onListFolderContinueLoaded();
+    void onListFolderPageLoaded();
+    void onListFolderPageParsed(const QVariant& json, bool ok, const QString& errorMessage);
     void onListFolderLongPoll();
     void onFolderCreated();
     void onFileDeleted();
     void onDeletedBatch();
     void onMoved();
     void onMovedBatch();
+    void onCopied();
+    void onCopiedBatch();
+    void onCombinedWriteLaunched();
+    void onRequestFinished();
+    void onRequestCancelled();
+    void checkTimeouts();
+    void admit();
     void onRenamed();
     void onThumbnailLoaded();
+    void onThumbnailBatchLoaded();
+    void onThumbnailsDecoded();
+    void flushThumbnailBatch();
     void onDownloaded();
     void onDownloadedZip();
+    void onFileDownloaded();
+    void onMaterialized(const QString& localPath, const bool& ok);
+    void onSettledDue();
+    void onDownloadStreamed();
     void onDownloadProgress(qint64 loaded, qint64 total);
     void onUploaded();
     void onUploadProgress(qint64 loaded, qint64 total);
     void onUploadSessionStarted();
     void onUploadSessionAppended();
     void onUploadSessionFinished();
+    void onUploadSessionFinishedBatch();
     void read();
     void readZip();
+    void readFile();
+    void readStream();
+    void onSinkWritten(qint64 bytes);
     void onTemporaryLinkLoaded();
     void onUrlSaved();
-    void onUploadError(QNetworkReply::NetworkError e);
     void onMetadataReceived();
 
     // sharing slots
@@ -275,6 +442,9 @@ private slots:
     void onSharedLinkRevoked();
     void onSharedLinksLoaded();
     void onJobStatusChecked();
+    void onAsyncJobChecked();
+    void onAsyncJobLaunched(const QString& type, const QString& asyncJobId);
+    void onAsyncJobFinished(const AsyncJobStatus& status);
 
     // users slots
     void onAccountLoaded();
@@ -285,10 +455,39 @@ private slots:
     void processUploadsQueue();
 
 private:
+    struct ListFolderPaging {
+        ListFolderPaging(const QString& path) : path(path), requested(0), emitted(0), fetching(false), done(false) {}
+
+        QString path;
+        QString token;
+        QString nextCursor;
+        QString lastCursor;
+        int requested;
+        int emitted;
+        bool fetching;
+        bool done;
+        QMap<int, QVariant> decoded;
+    };
+
+    struct Transfer {
+        Transfer() : body(0), queue(0) {}
+
+        QIODevice* body;
+        QByteArray readSlot;
+        QList<QNetworkReply*>* queue;
+    };
+
+    struct CombinedWrite {
+        QString kind;
+        QVariantList entries;
+        QList<QDropboxRequest*> batched;
+    };
+
     static Logger logger;
     static qint64 uploadSize;
 
-    QNetworkAccessManager m_network;
+    QNetworkAccessManager* m_pNetwork;
+    QTimer m_keepWarmTimer;
 
     QString m_authUrl;
     QString m_url;
@@ -297,6 +496,8 @@ private:
     int m_version;
 
     QString m_accessToken;
+    QString m_scopedToken;
+    QHash<QString, QString> m_jobTokens;
     QString m_appSecret;
     QString m_appKey;
     QString m_redirectUri;
@@ -312,6 +513,48 @@ private:
 
     QQueue<QDropboxUpload> m_uploads;
 
+    int m_maxBufferedPages;
+    int m_pagingId;
+    QHash<int, ListFolderPaging*> m_pagings;
+
+    bool m_coalesceRequests;
+    QDropboxThumbnailCache* m_pThumbnailCache;
+    QDropboxBlockStore* m_pBlockStore;
+    QMultiHash<QString, QDropboxRequest*> m_localDownloads;
+    QList<QDropboxRequest*> m_settledRequests;
+
+    bool m_thumbnailBatching;
+    QTimer m_thumbnailBatchTimer;
+    QSize m_thumbnailScaledSize;
+
+    bool m_writeCombining;
+    QTimer m_writeCombineTimer;
+    QList<QDropboxRequest*> m_pendingDeletes;
+    QMap<int, QList<QDropboxRequest*> > m_pendingMoves;
+    QHash<QString, CombinedWrite> m_combinedJobs;
+    QDropboxJobTracker* m_pJobTracker;
+
+    bool m_http2Allowed;
+    int m_maxConnectionsPerHost;
+    QHash<QString, int> m_hostLimits;
+    QHash<QString, int> m_hostLoad;
+    int m_maxRetries;
+    QList<QDropboxRequest*> m_pendingRequests;
+    QHash<QNetworkReply*, QDropboxRequest*> m_requests;
+    QHash<QIODevice*, QDropboxRequest*> m_sinks;
+    QHash<QDropboxRequest*, Transfer> m_transfers;
+    QTimer m_admissionTimer;
+    QNetworkReply* m_pCurrentReply;
+    QDropboxRequest* m_pCurrentRequest;
+    QDropboxRequestContext m_noContext;
+    int m_requestTimeout;
+    int m_stallTimeout;
+    QTimer m_watchdogTimer;
+    quint32 m_jitterState;
+    QList<QVariantMap> m_pendingThumbnails;
+    QHash<QString, QDropboxRequest*> m_inflight;
+    QMultiHash<QString, QDropboxRequest*> m_thumbnailRequests;
+
     void init();
     void generateFullUrl();
     void generateFullContentUrl();
@@ -322,8 +565,41 @@ private:
     QNetworkRequest prepareContentRequest(const QString& apiMethod, const bool& log = true);
     QNetworkRequest prepareNotifyRequest(const QString& apiMethod, const bool& log = true);
     QNetworkReply* getReply();
-
-    QNetworkReply* moveFile(const QString& fromPath, const QString& toPath, const bool& allowSharedFolder = false, const bool& autorename = false, const bool& allowOwnershipTransfer = false);
+    QDropboxRequestContext& context();
+    QString token() const;
+    void fetchNextPage(const int& pagingId);
+    bool peekCursor(const QByteArray& data, QString& cursor, bool& hasMore);
+    void settle(QDropboxRequest* request, QNetworkReply* reply);
+    QDropboxRequest* coalesce(const QString& key);
+    void registerInflight(const QString& key, QDropboxRequest* request);
+    void unregisterInflight(QNetworkReply* reply);
+    void settleJoined(QDropboxRequest* request);
+    QByteArray thumbnailArg(const QString& path, const QString& size, const QString& format) const;
+    QString thumbnailKey(const QString& path, const QString& size, const QString& format) const;
+    QDropboxRequest* enqueueThumbnail(const QString& path, const QString& size, const QString& format);
+    QDropboxRequest* findThumbnail(const QString& path, const QString& size, const QString& format);
+    QDropboxRequest* awaitThumbnail(const QString& key);
+    void settleThumbnail(const QString& key, const QImage& image, const QNetworkReply::NetworkError& error = QNetworkReply::NoError, const QString& errorString = "");
+    void decodeThumbnails(const QByteArray& data, const QVariantList& entries, const QDropboxThumbnailDecoder::Mode& mode);
+    void scheduleWrites(const int& pending);
+    QDropboxRequest* combine(const char* slot);
+    void postCombinedWrite(const QString& kind, const QString& apiMethod, const QVariantMap& map, const QVariantList& entries, const QList<QDropboxRequest*>& batched);
+    void completeCombinedWrite(const QString& kind, const QVariantMap& data, const QVariantList& entries, const QList<QDropboxRequest*>& batched);
+    void failCombinedWrite(const QList<QDropboxRequest*>& batched, const QNetworkReply::NetworkError& error, const QString& errorString);
+    void settleCombined(QDropboxRequest* request);
+    void emitThumbnail(const QString& path, const QString& size, const QString& format, const QByteArray& data, const QImage& image);
+
+    QDropboxRequest* moveFile(const QString& fromPath, const QString& toPath, const char* slot, const bool& allowSharedFolder = false, const bool& autorename = false, const bool& allowOwnershipTransfer = false);
+    QDropboxRequest* send(const QNetworkRequest& req, const QByteArray& data, const char* slot);
+    QDropboxRequest* resolved(const QVariant& value);
+    QDropboxRequest* rejected(const QNetworkReply::NetworkError& error, const QString& errorString);
+    void settleLater(QDropboxRequest* request);
+    QDropboxRequest* transfer(const QNetworkRequest& req, QIODevice* body, const char* readSlot, const char* slot, QList<QNetworkReply*>* queue = 0);
+    QDropboxRequest* stream(const QString& apiMethod, const QString& path, const QString& rev, QIODevice* sink);
+    void drain(QNetworkReply* reply, QIODevice* sink);
+    void dispatch(QDropboxRequest* request);
+    int retryDelay(QDropboxRequest* request, QNetworkReply* reply);
+    int jitter(const int& bound);
 };
 
 #endif /* QDROPBOX_HPP_ */
@@ -0,0 +1,52 @@
+/*
+ * QDropboxAccountPool.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#ifndef QDROPBOXACCOUNTPOOL_HPP_
+#define QDROPBOXACCOUNTPOOL_HPP_
+
+#include <QObject>
+#include <QHash>
+#include <QStringList>
+
+#include "QDropbox.hpp"
+#include "Logger.hpp"
+
+/**
+ * Serves many accounts with one QDropbox, so they share its network manager, connections and admission queue.
+ * An account costs no more than its id and token. account() binds the client to a token and every call made
+ * through it carries that token to the end, retries, further pages, job checks and joined calls included;
+ * admission then takes turns between accounts. Results should be taken from the returned handles, the signals
+ * of the client are shared by all accounts. Write combining and the thumbnail cache do not tell accounts apart
+ * and are switched off.
+ */
+class QDropboxAccountPool : public QObject {
+    Q_OBJECT
+public:
+    QDropboxAccountPool(QObject* parent = 0);
+    QDropboxAccountPool(QDropbox* dropbox, QObject* parent = 0);
+    virtual ~QDropboxAccountPool();
+
+    QDropbox* getDropbox() const;
+
+    QDropboxAccountPool& addAccount(const QString& accountId, const QString& accessToken);
+    QDropboxAccountPool& removeAccount(const QString& accountId);
+    bool hasAccount(const QString& accountId) const;
+    QStringList getAccounts() const;
+    int size() const;
+
+    QDropbox* account(const QString& accountId);
+
+private:
+    static Logger logger;
+
+    QDropbox* m_pDropbox;
+    QHash<QString, QString> m_tokens;
+
+    void init();
+};
+
+#endif /* QDROPBOXACCOUNTPOOL_HPP_ */
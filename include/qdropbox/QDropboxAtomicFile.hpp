@@ -0,0 +1,28 @@
+/*
+ * QDropboxAtomicFile.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#ifndef QDROPBOXATOMICFILE_HPP_
+#define QDROPBOXATOMICFILE_HPP_
+
+#include <QString>
+#include <QByteArray>
+
+/**
+ * Replaces a small state file as a whole. The data is written next to it, synced and renamed over it,
+ * so a crash leaves either the old or the new content, never a mix of them.
+ * Where rename cannot replace a file the old one is removed first, recover() puts back a complete new one left behind.
+ */
+class QDropboxAtomicFile {
+public:
+    static bool save(const QString& path, const QByteArray& data);
+    static void recover(const QString& path);
+
+private:
+    QDropboxAtomicFile();
+};
+
+#endif /* QDROPBOXATOMICFILE_HPP_ */
@@ -0,0 +1,48 @@
+/*
+ * QDropboxBlockCopy.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#ifndef QDROPBOXBLOCKCOPY_HPP_
+#define QDROPBOXBLOCKCOPY_HPP_
+
+#include <QObject>
+#include <QRunnable>
+#include <QString>
+
+/**
+ * Materializes one file of the block store on a pool thread: as a reflink where the filesystem supports it,
+ * as a hard link when enabled, otherwise as a plain copy. The target only appears once it is complete.
+ */
+class QDropboxBlockCopy : public QObject, public QRunnable {
+    Q_OBJECT
+public:
+    QDropboxBlockCopy(const QString& contentHash, const QString& source, const QString& localPath, const bool& hardLinks = false, QObject* parent = 0);
+    virtual ~QDropboxBlockCopy();
+
+    void run();
+
+    const QString& getContentHash() const;
+    const QString& getSource() const;
+    const QString& getLocalPath() const;
+    const QString& getTarget() const;
+    bool isCopied() const;
+    const QString& getErrorString() const;
+
+Q_SIGNALS:
+    void copied();
+
+private:
+    QString m_contentHash;
+    QString m_source;
+    QString m_localPath;
+    QString m_target;
+    bool m_hardLinks;
+    QString m_errorString;
+
+    bool link(const QString& source, const QString& target) const;
+};
+
+#endif /* QDROPBOXBLOCKCOPY_HPP_ */
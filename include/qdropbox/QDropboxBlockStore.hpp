@@ -0,0 +1,70 @@
+/*
+ * QDropboxBlockStore.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#ifndef QDROPBOXBLOCKSTORE_HPP_
+#define QDROPBOXBLOCKSTORE_HPP_
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QTimer>
+
+#include "Logger.hpp"
+
+/**
+ * Index of local files by their Dropbox content_hash, kept in an index file. A download of content already present
+ * locally is materialized from the indexed copy instead, on the thread pool (see QDropboxBlockCopy); materialized()
+ * reports the outcome. Files changed since they were indexed are never used.
+ */
+class QDropboxBlockStore : public QObject {
+    Q_OBJECT
+public:
+    QDropboxBlockStore(const QString& indexPath, QObject* parent = 0);
+    virtual ~QDropboxBlockStore();
+
+    const QString& getIndexPath() const;
+
+    const bool& isHardLinks() const;
+    QDropboxBlockStore& setHardLinks(const bool& hardLinks);
+
+    QString find(const QString& contentHash);
+    bool materialize(const QString& contentHash, const QString& localPath);
+    void insert(const QString& contentHash, const QString& localPath);
+    void remove(const QString& localPath);
+    void clear();
+
+Q_SIGNALS:
+    void materialized(const QString& localPath, const bool& ok);
+
+public slots:
+    void save();
+
+private slots:
+    void onCopied();
+
+private:
+    struct Block {
+        Block() : size(0), modified(0) {}
+
+        QString path;
+        qint64 size;
+        qint64 modified;
+    };
+
+    static Logger logger;
+
+    QString m_indexPath;
+    bool m_hardLinks;
+    QHash<QString, QList<Block> > m_blocks;
+    QHash<QString, QString> m_hashes;
+    QTimer m_saveTimer;
+
+    void load();
+    void scheduleSave();
+};
+
+#endif /* QDROPBOXBLOCKSTORE_HPP_ */
@@ -10,5 +10,14 @@
 
 #define FOLDER_TAG "folder"
 #define FILE_TAG "file"
+#define DELETED_TAG "deleted"
+
+#define DELETE_BATCH_JOB "delete_batch"
+#define MOVE_BATCH_JOB "move_batch"
+#define MOVE_BATCH_V2_JOB "move_batch_v2"
+#define COPY_BATCH_V2_JOB "copy_batch_v2"
+#define SHARE_FOLDER_JOB "share_folder"
+#define UNSHARE_FOLDER_JOB "unshare_folder"
+#define UPLOAD_SESSION_FINISH_BATCH_JOB "upload_session_finish_batch"
 
 #endif /* QDROPBOXCOMMON_HPP_ */
@@ -0,0 +1,86 @@
+/*
+ * QDropboxConcurrentClient.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#ifndef QDROPBOXCONCURRENTCLIENT_HPP_
+#define QDROPBOXCONCURRENTCLIENT_HPP_
+
+#include <QObject>
+#include <QList>
+#include <QThread>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QVariantMap>
+#include <QNetworkReply>
+#include <QtGui/QImage>
+
+#include "QDropboxWorker.hpp"
+#include "QDropboxFile.hpp"
+#include "QDropboxTempLink.hpp"
+#include "Logger.hpp"
+
+/**
+ * Thread-safe front-end over a pool of worker threads, each with its own QDropbox and network manager.
+ * Calls may come from any thread and are handed round-robin to the workers; all workers share the
+ * configuration, and since they share the access token they also share its rate limiter.
+ * Signals are delivered on the thread the client lives on. Objects passed by them still belong to
+ * a worker thread, release them with deleteLater().
+ */
+class QDropboxConcurrentClient : public QObject {
+    Q_OBJECT
+public:
+    QDropboxConcurrentClient(const QString& accessToken, const int& threads = QThread::idealThreadCount(), QObject* parent = 0);
+    virtual ~QDropboxConcurrentClient();
+
+    int size() const;
+
+    QString getAccessToken() const;
+    QDropboxConcurrentClient& setAccessToken(const QString& accessToken);
+
+    QVariantMap getConfiguration() const;
+    QDropboxConcurrentClient& configure(const QVariantMap& configuration);
+
+    void getMetadata(const QString& path, const bool& includeMediaInfo = false);
+    void listFolder(const QString& path = "", const bool& includeMediaInfo = false, const bool& recursive = false);
+    void listFolderContinue(const QString& cursor);
+    void getThumbnail(const QString& path, const QString& size = "w128h128", const QString& format = "jpeg");
+    void getTemporaryLink(const QString& path);
+    void download(const QString& path, const QString& rev = "");
+    void upload(const QString& localPath, const QString& remotePath, const QString& mode = "add");
+    void createFolder(const QString& path, const bool& autorename = false);
+    void deleteFile(const QString& path);
+    void move(const QString& fromPath, const QString& toPath);
+    void copy(const QString& fromPath, const QString& toPath);
+
+Q_SIGNALS:
+    void listFolderLoaded(const QString& path, const QList<QDropboxFile*>& files, const QString& cursor, const bool& hasMore);
+    void listFolderContinueLoaded(const QList<QDropboxFile*>& files, const QString& prevCursor, const QString& cursor, const bool& hasMore);
+    void metadataReceived(QDropboxFile* file);
+    void thumbnailLoaded(const QString& path, const QString& size, QImage* thumbnail);
+    void temporaryLinkLoaded(QDropboxTempLink* link);
+    void downloaded(const QString& path, const QString& localPath);
+    void uploaded(QDropboxFile* file);
+    void uploadFailed(const QString& reason);
+    void folderCreated(QDropboxFile* folder);
+    void fileDeleted(QDropboxFile* file);
+    void moved(QDropboxFile* file, const QString& fromPath, const QString& toPath);
+    void copied(QDropboxFile* file, const QString& fromPath, const QString& toPath);
+    void error(QNetworkReply::NetworkError e, const QString& errorString);
+
+private:
+    static Logger logger;
+
+    mutable QMutex m_mutex;
+    QVariantMap m_configuration;
+    QList<QThread*> m_threads;
+    QList<QDropboxWorker*> m_workers;
+    QAtomicInt m_next;
+
+    QDropboxWorker* next();
+    void connectWorker(QDropboxWorker* worker);
+};
+
+#endif /* QDROPBOXCONCURRENTCLIENT_HPP_ */
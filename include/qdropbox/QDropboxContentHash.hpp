@@ -0,0 +1,39 @@
+/*
+ * QDropboxContentHash.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#ifndef QDROPBOXCONTENTHASH_HPP_
+#define QDROPBOXCONTENTHASH_HPP_
+
+#include <QString>
+#include <QByteArray>
+
+class QDropboxSha256;
+
+/**
+ * Dropbox content_hash: the SHA-256 of the concatenated SHA-256 digests of every 4 MB block of the data.
+ * Lets local files be compared with remote ones without transferring them.
+ */
+class QDropboxContentHash {
+public:
+    QDropboxContentHash();
+    virtual ~QDropboxContentHash();
+
+    void addData(const char* data, const int& size);
+    void addData(const QByteArray& data);
+    QString result();
+
+    static QString file(const QString& path);
+
+private:
+    QDropboxSha256* m_pBlock;
+    QByteArray m_digests;
+    qint64 m_blockSize;
+
+    Q_DISABLE_COPY(QDropboxContentHash)
+};
+
+#endif /* QDROPBOXCONTENTHASH_HPP_ */
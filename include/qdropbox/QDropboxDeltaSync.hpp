@@ -0,0 +1,93 @@
+/*
+ * QDropboxDeltaSync.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#ifndef QDROPBOXDELTASYNC_HPP_
+#define QDROPBOXDELTASYNC_HPP_
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QStringList>
+#include <QTimer>
+#include <QDateTime>
+#include <QNetworkReply>
+
+#include "QDropbox.hpp"
+#include "QDropboxFile.hpp"
+#include "Logger.hpp"
+
+/**
+ * Keeps a change feed of a Dropbox folder. Lists the folder once, then keeps a longpoll open
+ * and pages through list_folder/continue as soon as it reports changes, honoring the server backoff.
+ * Every page is split into added, modified and deleted batches. Only failures of its own calls make it retry.
+ */
+class QDropboxDeltaSync : public QObject {
+    Q_OBJECT
+public:
+    QDropboxDeltaSync(QDropbox* dropbox, QObject* parent = 0);
+    virtual ~QDropboxDeltaSync();
+
+    const QString& getPath() const;
+    const bool& isRecursive() const;
+
+    const QString& getCursor() const;
+    QDropboxDeltaSync& setCursor(const QString& cursor);
+
+    const int& getTimeout() const;
+    QDropboxDeltaSync& setTimeout(const int& timeout);
+
+    bool isRunning() const;
+
+public slots:
+    void start(const QString& path = "", const bool& recursive = true);
+    void stop();
+
+Q_SIGNALS:
+    void added(const QList<QDropboxFile*>& files);
+    void modified(const QList<QDropboxFile*>& files);
+    void deleted(const QStringList& paths);
+    void synced(const QString& cursor);
+
+private slots:
+    void onListFolderLoaded(const QString& path, QList<QDropboxFile*>& files, const QString& cursor, const bool& hasMore);
+    void onListFolderContinueLoaded(QList<QDropboxFile*>& files, const QString& prevCursor, const QString& cursor, const bool& hasMore);
+    void onListFolderLongPollFinished(const QString& cursor, const bool& changes, const int& backoff);
+    void onRequestFailed(QNetworkReply::NetworkError e, const QString& errorString);
+    void onRequestFinished();
+    void resume();
+
+private:
+    enum State {
+        Idle,
+        Listing,
+        Continuing,
+        Polling,
+        Waiting
+    };
+
+    static Logger logger;
+
+    QDropbox* m_pDropbox;
+    QString m_path;
+    bool m_recursive;
+    QString m_cursor;
+    int m_timeout;
+    State m_state;
+    State m_resumeState;
+    int m_retryDelay;
+    QDateTime m_backoffUntil;
+    QTimer m_timer;
+    QHash<QString, QString> m_revs;
+    QDropboxRequest* m_pRequest;
+
+    void track(QDropboxRequest* request);
+    void processPage(QList<QDropboxFile*>& files, const QString& cursor, const bool& hasMore);
+    void poll();
+    void wait(const int& msec, const State& resumeState);
+};
+
+#endif /* QDROPBOXDELTASYNC_HPP_ */
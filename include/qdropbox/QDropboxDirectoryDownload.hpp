@@ -0,0 +1,120 @@
+/*
+ * QDropboxDirectoryDownload.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#ifndef QDROPBOXDIRECTORYDOWNLOAD_HPP_
+#define QDROPBOXDIRECTORYDOWNLOAD_HPP_
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QNetworkReply>
+
+#include "QDropbox.hpp"
+#include "QDropboxFile.hpp"
+#include "QDropboxZipExtractor.hpp"
+#include "Logger.hpp"
+
+/**
+ * Downloads a Dropbox folder tree into a local directory. The tree is listed first, then every subtree holding many
+ * small files is fetched as one zip extracted while it streams in, everything else file by file.
+ * Up to getConcurrency() downloads run at once. A subtree whose zip fails falls back to single files.
+ * All folders are created locally, including empty ones, whichever way their files arrive.
+ */
+class QDropboxDirectoryDownload : public QObject {
+    Q_OBJECT
+public:
+    QDropboxDirectoryDownload(QDropbox* dropbox, const QString& remotePath, const QString& localPath, QObject* parent = 0);
+    virtual ~QDropboxDirectoryDownload();
+
+    const QString& getRemotePath() const;
+    const QString& getLocalPath() const;
+
+    const int& getConcurrency() const;
+    QDropboxDirectoryDownload& setConcurrency(const int& concurrency);
+
+    const int& getZipMinFiles() const;
+    QDropboxDirectoryDownload& setZipMinFiles(const int& zipMinFiles);
+
+    const qint64& getZipMaxAverageSize() const;
+    QDropboxDirectoryDownload& setZipMaxAverageSize(const qint64& zipMaxAverageSize);
+
+    bool isRunning() const;
+
+public slots:
+    void start();
+    void cancel();
+
+Q_SIGNALS:
+    void planned(int files, qint64 bytes, int archives);
+    void progress(qint64 received, qint64 total);
+    void finished();
+    void failed(const QString& reason);
+
+private slots:
+    void onListFolderLoaded(const QString& path, QList<QDropboxFile*>& files, const QString& cursor, const bool& hasMore);
+    void onListFolderContinueLoaded(QList<QDropboxFile*>& files, const QString& prevCursor, const QString& cursor, const bool& hasMore);
+    void onListingFailed(QNetworkReply::NetworkError e, const QString& errorString);
+    void onDownloadProgress(const QString& path, qint64 loaded, qint64 total);
+    void onFileDownloaded(const QVariant& value);
+    void onFileFailed(QNetworkReply::NetworkError e, const QString& errorString);
+    void onArchiveDownloaded(const QVariant& value);
+    void onArchiveFailed(QNetworkReply::NetworkError e, const QString& errorString);
+
+private:
+    struct Entry {
+        Entry() : folder(false), size(0) {}
+
+        QString path;
+        bool folder;
+        qint64 size;
+        QString rev;
+        QString contentHash;
+    };
+
+    struct Archive {
+        Archive() : size(0), pExtractor(0) {}
+
+        QString path;
+        qint64 size;
+        QList<Entry> files;
+        QDropboxZipExtractor* pExtractor;
+    };
+
+    static Logger logger;
+
+    QDropbox* m_pDropbox;
+    QString m_remotePath;
+    QString m_localPath;
+    int m_concurrency;
+    int m_zipMinFiles;
+    qint64 m_zipMaxAverageSize;
+    bool m_running;
+    bool m_listing;
+    QString m_cursor;
+    QList<Entry> m_entries;
+
+    QList<Archive> m_archives;
+    QList<Entry> m_files;
+    QHash<QDropboxRequest*, Archive> m_archiveRequests;
+    QHash<QDropboxRequest*, Entry> m_fileRequests;
+    QHash<QString, qint64> m_inflight;
+    int m_done;
+    int m_failures;
+    qint64 m_received;
+    qint64 m_total;
+
+    void list();
+    void plan();
+    void pump();
+    void startArchive(const Archive& archive);
+    void startFile(const Entry& entry);
+    void done(const QString& remotePath, const qint64& size);
+    QString localFilePath(const QString& path) const;
+    QString remoteFilePath(const QString& path) const;
+};
+
+#endif /* QDROPBOXDIRECTORYDOWNLOAD_HPP_ */
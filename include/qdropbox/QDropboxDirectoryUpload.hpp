@@ -0,0 +1,104 @@
+/*
+ * QDropboxDirectoryUpload.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#ifndef QDROPBOXDIRECTORYUPLOAD_HPP_
+#define QDROPBOXDIRECTORYUPLOAD_HPP_
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QNetworkReply>
+
+#include "QDropbox.hpp"
+#include "QDropboxLocalScanner.hpp"
+#include "QDropboxSessionUpload.hpp"
+#include "Logger.hpp"
+
+/**
+ * Uploads a local directory tree. The tree is walked in parallel, folders are only created
+ * when they are empty since uploading a file creates the folders above it.
+ * Small files are sent as closed upload sessions and committed together through finish_batch,
+ * large ones go through chunked sessions of their own. Up to getConcurrency() calls run at once,
+ * progress is reported in bytes for the whole tree.
+ */
+class QDropboxDirectoryUpload : public QObject {
+    Q_OBJECT
+public:
+    QDropboxDirectoryUpload(QDropbox* dropbox, const QString& localPath, const QString& remotePath, const QString& mode = "add", QObject* parent = 0);
+    virtual ~QDropboxDirectoryUpload();
+
+    const QString& getLocalPath() const;
+    const QString& getRemotePath() const;
+
+    const int& getConcurrency() const;
+    QDropboxDirectoryUpload& setConcurrency(const int& concurrency);
+
+    const qint64& getSmallFileSize() const;
+    QDropboxDirectoryUpload& setSmallFileSize(const qint64& smallFileSize);
+
+    bool isRunning() const;
+
+public slots:
+    void start();
+    void cancel();
+
+Q_SIGNALS:
+    void planned(int files, qint64 bytes);
+    void progress(qint64 sent, qint64 total);
+    void finished();
+    void failed(const QString& reason);
+
+private slots:
+    void onScanned();
+    void onSessionStarted(const QVariant& value);
+    void onFolderCreated(const QVariant& value);
+    void onRequestFailed(QNetworkReply::NetworkError e, const QString& errorString);
+    void onUploadProgress(qint64 sent, qint64 total);
+    void onUploaded(const QVariant& metadata);
+    void onUploadFailed(const QString& reason);
+    void onBatchLaunched(const QVariant& value);
+    void onBatchFailed(QNetworkReply::NetworkError e, const QString& errorString);
+    void onJobFinished(const AsyncJobStatus& status);
+
+private:
+    static Logger logger;
+
+    QDropbox* m_pDropbox;
+    QString m_localPath;
+    QString m_remotePath;
+    QString m_mode;
+    int m_concurrency;
+    qint64 m_smallFileSize;
+    bool m_running;
+    QList<QDropboxLocalScanner*> m_scanners;
+    QList<LocalEntry> m_entries;
+
+    QList<LocalEntry> m_folders;
+    QList<LocalEntry> m_smallFiles;
+    QList<LocalEntry> m_largeFiles;
+    QHash<QDropboxRequest*, LocalEntry> m_requests;
+    int m_starting;
+    QHash<QDropboxSessionUpload*, qint64> m_uploads;
+    QList<UploadSessionEntry> m_commits;
+    QList<UploadSessionEntry> m_batch;
+    QDropboxRequest* m_pBatchRequest;
+    QString m_jobId;
+    int m_files;
+    int m_failures;
+    qint64 m_sent;
+    qint64 m_total;
+
+    void plan();
+    void pump();
+    bool startNext();
+    void commit();
+    void batchDone(const QVariantList& entries, const bool& ok);
+    void fail(const QString& path, const QString& reason);
+    QString remoteFilePath(const QString& path) const;
+};
+
+#endif /* QDROPBOXDIRECTORYUPLOAD_HPP_ */
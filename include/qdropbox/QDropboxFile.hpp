@@ -10,6 +10,7 @@
 
 #include <QObject>
 #include <QVariantMap>
+#include "QDropboxPathTree.hpp"
 
 struct SharingInfo : public QObject {
 
@@ -219,10 +220,10 @@ public:
     const QString& getName() const;
     QDropboxFile& setName(const QString& name);
 
-    const QString& getPathLower() const;
+    QString getPathLower() const;
     QDropboxFile& setPathLower(const QString& pathLower);
 
-    const QString& getPathDisplay() const;
+    QString getPathDisplay() const;
     QDropboxFile& setPathDisplay(const QString& pathDisplay);
 
     const QString& getId() const;
@@ -258,8 +259,7 @@ public:
 private:
     QString m_tag;
     QString m_name;
-    QString m_pathLower;
-    QString m_pathDisplay;
+    QDropboxPathTree::Node* m_pPath;
     QString m_id;
     QString m_sharedFolderId;
     SharingInfo* m_sharingInfo;
@@ -273,6 +273,7 @@ private:
     MediaInfo* m_mediaInfo;
 
     void swap(const QDropboxFile& file);
+    void setPath(const QString& pathLower, const QString& pathDisplay);
 };
 
 #endif /* QDROPBOXFILE_HPP_ */
@@ -0,0 +1,78 @@
+/*
+ * QDropboxJobTracker.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#ifndef QDROPBOXJOBTRACKER_HPP_
+#define QDROPBOXJOBTRACKER_HPP_
+
+#include <QObject>
+#include <QHash>
+#include <QTimer>
+
+#include "QDropbox.hpp"
+#include "Logger.hpp"
+
+/**
+ * Polls the check endpoints of outstanding Dropbox async jobs. Every job starts with a short interval
+ * which grows exponentially while the job is in progress, all jobs share a single timer armed for the closest check.
+ * A check lost on the connection is sent again a few times, a check refused for any other reason fails the job.
+ * Jobs announced by QDropbox through asyncJobLaunched() are tracked automatically.
+ */
+class QDropboxJobTracker : public QObject {
+    Q_OBJECT
+public:
+    QDropboxJobTracker(QDropbox* dropbox, QObject* parent = 0);
+    virtual ~QDropboxJobTracker();
+
+    const int& getMinInterval() const;
+    QDropboxJobTracker& setMinInterval(const int& minInterval);
+
+    const int& getMaxInterval() const;
+    QDropboxJobTracker& setMaxInterval(const int& maxInterval);
+
+    bool isTracking(const QString& asyncJobId) const;
+    int size() const;
+
+public slots:
+    void track(const QString& type, const QString& asyncJobId);
+    void untrack(const QString& asyncJobId);
+
+Q_SIGNALS:
+    void completed(const AsyncJobStatus& status);
+    void failed(const AsyncJobStatus& status);
+    void finished(const AsyncJobStatus& status);
+
+private slots:
+    void onAsyncJobChecked(const AsyncJobStatus& status);
+    void onCheckSucceeded(const QVariant& value);
+    void onCheckFailed(QNetworkReply::NetworkError e, const QString& errorString);
+    void checkDue();
+
+private:
+    struct Job {
+        Job() : interval(0), nextCheck(0), checkSent(0), failures(0) {}
+
+        QString type;
+        int interval;
+        qint64 nextCheck;
+        qint64 checkSent;
+        int failures;
+    };
+
+    static Logger logger;
+
+    QDropbox* m_pDropbox;
+    int m_minInterval;
+    int m_maxInterval;
+    QHash<QString, Job> m_jobs;
+    QHash<QDropboxRequest*, QString> m_checks;
+    QTimer m_timer;
+
+    void schedule();
+    void fail(const QString& asyncJobId, const QString& errorString);
+};
+
+#endif /* QDROPBOXJOBTRACKER_HPP_ */
@@ -0,0 +1,65 @@
+/*
+ * QDropboxLocalScanner.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#ifndef QDROPBOXLOCALSCANNER_HPP_
+#define QDROPBOXLOCALSCANNER_HPP_
+
+#include <QObject>
+#include <QRunnable>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+struct LocalEntry {
+    LocalEntry() : folder(false), size(0), modified(0) {}
+
+    QString path;
+    bool folder;
+    qint64 size;
+    qint64 modified;
+    QString contentHash;
+};
+
+/**
+ * Walks one directory of a local tree on a pool thread, recursively or just its own entries.
+ * Paths are relative to the root of the tree. Content hashes are only computed for files whose
+ * size or modification time differ from the known entry of the same path, see setKnown().
+ * Several scanners over disjoint directories walk a tree in parallel.
+ */
+class QDropboxLocalScanner : public QObject, public QRunnable {
+    Q_OBJECT
+public:
+    QDropboxLocalScanner(const QString& root, const QString& directory = "", const bool& recursive = true, QObject* parent = 0);
+    virtual ~QDropboxLocalScanner();
+
+    void run();
+
+    const QString& getRoot() const;
+    const QString& getDirectory() const;
+
+    const bool& isHashing() const;
+    QDropboxLocalScanner& setHashing(const bool& hashing);
+
+    QDropboxLocalScanner& setKnown(const QHash<QString, LocalEntry>& known);
+
+    const QList<LocalEntry>& getEntries() const;
+
+    static QList<QDropboxLocalScanner*> split(const QString& root, const QHash<QString, LocalEntry>& known = QHash<QString, LocalEntry>());
+
+Q_SIGNALS:
+    void scanned();
+
+private:
+    QString m_root;
+    QString m_directory;
+    bool m_recursive;
+    bool m_hashing;
+    QHash<QString, LocalEntry> m_known;
+    QList<LocalEntry> m_entries;
+};
+
+#endif /* QDROPBOXLOCALSCANNER_HPP_ */
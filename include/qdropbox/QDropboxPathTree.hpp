@@ -0,0 +1,65 @@
+/*
+ * QDropboxPathTree.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#ifndef QDROPBOXPATHTREE_HPP_
+#define QDROPBOXPATHTREE_HPP_
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QAtomicInt>
+
+/**
+ * Shared trie of path components. Every node keeps its lowercased segment and the segment as displayed;
+ * segments equal but for casing are sibling nodes, so every path keeps the casing it was acquired with.
+ * Nodes are reference counted by their holders and pruned when neither holders nor children are left.
+ * A held node and its ancestors never change, paths are rebuilt from them without the lock.
+ */
+class QDropboxPathTree {
+public:
+    struct Node {
+        Node(Node* parent = 0) : parent(parent), refs(0) {}
+
+        Node* parent;
+        QString lower;
+        QString display;
+        QMultiHash<QString, Node*> children;
+        QAtomicInt refs;
+    };
+
+    QDropboxPathTree();
+    virtual ~QDropboxPathTree();
+
+    static QDropboxPathTree* instance();
+
+    Node* acquire(const QString& pathLower, const QString& pathDisplay);
+    Node* retain(Node* node);
+    void release(Node* node);
+
+    QString pathLower(const Node* node) const;
+    QString pathDisplay(const Node* node) const;
+
+    bool contains(const QString& pathLower) const;
+    QStringList subtree(const QString& pathLower, const bool& display = false) const;
+    int size() const;
+
+private:
+    Node m_root;
+    int m_size;
+    mutable QMutex m_mutex;
+
+    void find(const Node* node, const QStringList& segments, const int& index, QList<const Node*>& found) const;
+    void collect(const Node* node, QStringList& list, const bool& display) const;
+    QString path(const Node* node, const bool& display) const;
+    void destroy(Node* node);
+
+    Q_DISABLE_COPY(QDropboxPathTree)
+};
+
+#endif /* QDROPBOXPATHTREE_HPP_ */
@@ -0,0 +1,46 @@
+/*
+ * QDropboxRateLimiter.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#ifndef QDROPBOXRATELIMITER_HPP_
+#define QDROPBOXRATELIMITER_HPP_
+
+#include <QString>
+#include <QMutex>
+#include <QSharedPointer>
+
+/**
+ * Token bucket pacing the requests of one Dropbox namespace. Limiters are shared by all QDropbox
+ * instances using the same access token, so a server backoff applies to every one of them.
+ * A limiter back in its initial state is dropped once a limiter for another namespace is created.
+ */
+class QDropboxRateLimiter {
+public:
+    QDropboxRateLimiter();
+    virtual ~QDropboxRateLimiter();
+
+    static QSharedPointer<QDropboxRateLimiter> forNamespace(const QString& key);
+
+    double getRate() const;
+    int getBurst() const;
+    void setRate(const double& rate, const int& burst);
+
+    int acquire();
+    void pause(const int& msec);
+    bool isIdle() const;
+
+private:
+    mutable QMutex m_mutex;
+    double m_rate;
+    int m_burst;
+    double m_tokens;
+    qint64 m_updated;
+    qint64 m_pausedUntil;
+
+    void refill(const qint64& now);
+};
+
+#endif /* QDROPBOXRATELIMITER_HPP_ */
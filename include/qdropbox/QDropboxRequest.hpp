@@ -0,0 +1,207 @@
+/*
+ * QDropboxRequest.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#ifndef QDROPBOXREQUEST_HPP_
+#define QDROPBOXREQUEST_HPP_
+
+#include <QObject>
+#include <QNetworkRequest>
+#include <QNetworkReply>
+#include <QByteArray>
+#include <QIODevice>
+#include <QList>
+#include <QPair>
+#include <QPointer>
+#include <QStringList>
+#include <QVariantList>
+#include <QVariantMap>
+
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#endif
+
+#include "QDropboxMember.hpp"
+
+class QDropboxRequest;
+
+/**
+ * Typed state of one call: filled in when the call is made and read back by its handler.
+ * Fields a call does not need stay empty, userData is left to the caller.
+ */
+struct QDropboxRequestContext {
+    QDropboxRequestContext() : device(0), pagingId(0), page(0) {}
+
+    QString path;
+    QString cursor;
+    QString fromPath;
+    QString toPath;
+    QString size;
+    QString format;
+    QString sessionId;
+    QString sharedFolderId;
+    QString url;
+    QString type;
+    QString asyncJobId;
+    QString coalesceKey;
+    QString localPath;
+    QString rev;
+    QIODevice* device;
+    QStringList paths;
+    QList<QPair<QString, QString> > moves;
+    QVariantList entries;
+    QList<QDropboxRequest*> batched;
+    QList<QDropboxRequest*> joined;
+    QDropboxMember member;
+    int pagingId;
+    int page;
+    QVariantMap userData;
+};
+
+/**
+ * Outcome of one call. The value is the result Dropbox returned for it, parsed from the response body or,
+ * for content calls, from the Dropbox-API-Result header.
+ */
+struct QDropboxResult {
+    QDropboxResult() : error(QNetworkReply::NoError) {}
+
+    bool isOk() const { return error == QNetworkReply::NoError; }
+
+    QVariant value;
+    QNetworkReply::NetworkError error;
+    QString errorString;
+};
+
+/**
+ * Handle of a QDropbox call. Keeps everything needed to send the call again: the request, its body,
+ * the QDropbox slot handling the reply and the context the slot reads. finished() is emitted once the call is over.
+ * A call can be cancelled at any time, it fails once it runs longer than its timeout or stalls longer than its stall timeout.
+ *
+ * The handle also resolves with the result of this call only, through succeeded() or failed(), continuations added with then()
+ * or co_await where coroutines are available. It is deleted right after it finished, so continuations have to be added
+ * before returning to the event loop. then() returns the handle of the continuation: it settles once the continuation ran,
+ * with the result of this call or, when the continuation slot returns a QDropboxRequest*, with the result of that call.
+ */
+class QDropboxRequest : public QObject {
+    Q_OBJECT
+public:
+    QDropboxRequest(const QNetworkRequest& request, const QByteArray& data, const char* slot, QObject* parent = 0);
+    virtual ~QDropboxRequest();
+
+    const QNetworkRequest& getRequest() const;
+    const QByteArray& getData() const;
+    const QByteArray& getSlot() const;
+
+    const QDropboxRequestContext& getContext() const;
+    QDropboxRequestContext& getContext();
+
+    const QString& getNamespace() const;
+    QDropboxRequest& setNamespace(const QString& ns);
+
+    const bool& isIdempotent() const;
+    QDropboxRequest& setIdempotent(const bool& idempotent);
+
+    const bool& isReportErrors() const;
+    QDropboxRequest& setReportErrors(const bool& reportErrors);
+
+    const int& getAttempts() const;
+    QDropboxRequest& setAttempts(const int& attempts);
+
+    const qint64& getNotBefore() const;
+    QDropboxRequest& setNotBefore(const qint64& notBefore);
+
+    const int& getTimeout() const;
+    QDropboxRequest& setTimeout(const int& timeout);
+
+    const int& getStallTimeout() const;
+    QDropboxRequest& setStallTimeout(const int& stallTimeout);
+
+    QNetworkReply* getReply() const;
+    QDropboxRequest& setReply(QNetworkReply* reply);
+
+    const qint64& getCreatedAt() const;
+    const qint64& getStartedAt() const;
+    const qint64& getFinishedAt() const;
+
+    const bool& isCancelled() const;
+    const bool& isTimedOut() const;
+    const bool& isFinished() const;
+    bool isExpired(const qint64& now) const;
+    void expire();
+    void finish();
+
+    const QDropboxResult& getResult() const;
+    void resolve(const QVariant& value);
+    void reject(const QNetworkReply::NetworkError& error, const QString& errorString);
+    bool isAwaited() const;
+
+    QDropboxRequest* then(QObject* receiver, const char* onSucceeded, const char* onFailed = 0);
+
+#if defined(__cpp_impl_coroutine)
+    struct Awaiter {
+        QDropboxRequest* request;
+
+        bool await_ready() const { return request->isFinished(); }
+        void await_suspend(std::coroutine_handle<> handle) { request->m_pAwaiting = handle.address(); }
+        QDropboxResult await_resume() const { return request->getResult(); }
+    };
+
+    Awaiter operator co_await() {
+        Awaiter awaiter = { this };
+        return awaiter;
+    }
+#endif
+
+public slots:
+    void cancel();
+    void touch();
+
+Q_SIGNALS:
+    void cancelled();
+    void finished();
+    void succeeded(const QVariant& value);
+    void failed(QNetworkReply::NetworkError error, const QString& errorString);
+
+private slots:
+    void onSourceFinished();
+
+private:
+    struct Continuation {
+        QPointer<QObject> receiver;
+        QByteArray onSucceeded;
+        QByteArray onFailed;
+        QDropboxRequest* next;
+    };
+
+    QNetworkRequest m_request;
+    QByteArray m_data;
+    QByteArray m_slot;
+    QDropboxRequestContext m_context;
+    QString m_namespace;
+    bool m_idempotent;
+    bool m_reportErrors;
+    int m_attempts;
+    qint64 m_notBefore;
+    int m_timeout;
+    int m_stallTimeout;
+    qint64 m_createdAt;
+    qint64 m_startedAt;
+    qint64 m_lastActivity;
+    qint64 m_finishedAt;
+    bool m_cancelled;
+    bool m_timedOut;
+    bool m_finished;
+    QNetworkReply* m_pReply;
+    QDropboxResult m_result;
+    void* m_pAwaiting;
+    QList<Continuation> m_continuations;
+
+    QDropboxRequest* run(const Continuation& continuation);
+    void settleWith(const QDropboxResult& result);
+    static QByteArray methodName(const char* slot);
+};
+
+#endif /* QDROPBOXREQUEST_HPP_ */
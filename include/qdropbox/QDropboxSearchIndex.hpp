@@ -0,0 +1,110 @@
+/*
+ * QDropboxSearchIndex.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#ifndef QDROPBOXSEARCHINDEX_HPP_
+#define QDROPBOXSEARCHINDEX_HPP_
+
+#include <QObject>
+#include <QList>
+#include <QMap>
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+#include <QVariantMap>
+
+#include "QDropbox.hpp"
+#include "QDropboxFile.hpp"
+#include "QDropboxDeltaSync.hpp"
+#include "QDropboxCommon.hpp"
+
+struct QDropboxIndexEntry {
+    QDropboxIndexEntry() : size(0) {}
+
+    QString tag;
+    QString name;
+    QString pathLower;
+    QString pathDisplay;
+    QString id;
+    QString rev;
+    qint64 size;
+    QString contentHash;
+    QString serverModified;
+
+    bool isDir() const {
+        return tag.compare(FOLDER_TAG) == 0;
+    }
+
+    QVariantMap toMap() const {
+        QVariantMap map;
+        map[".tag"] = tag;
+        map["name"] = name;
+        map["path_lower"] = pathLower;
+        map["path_display"] = pathDisplay;
+        map["id"] = id;
+        map["rev"] = rev;
+        map["size"] = size;
+        map["content_hash"] = contentHash;
+        map["server_modified"] = serverModified;
+        return map;
+    }
+
+    void fromFile(const QDropboxFile& file) {
+        tag = file.getTag();
+        name = file.getName();
+        pathLower = file.getPathLower();
+        pathDisplay = file.getPathDisplay();
+        id = file.getId();
+        rev = file.getRev();
+        size = file.getSize();
+        contentHash = file.getContentHash();
+        serverModified = file.getServerModified();
+    }
+};
+
+/**
+ * Local index over listing results. Entries are kept ordered by lowercased path (subtree lookups are
+ * range scans), by every word of the lowercased name (prefix lookups) and bucketed by extension.
+ */
+class QDropboxSearchIndex : public QObject {
+    Q_OBJECT
+public:
+    QDropboxSearchIndex(QObject* parent = 0);
+    virtual ~QDropboxSearchIndex();
+
+    void attach(QDropbox* dropbox);
+    void attach(QDropboxDeltaSync* deltaSync);
+
+    int size() const;
+    bool contains(const QString& path) const;
+    QDropboxIndexEntry entry(const QString& path) const;
+
+    QList<QDropboxIndexEntry> findByPrefix(const QString& prefix, const int& limit = 100) const;
+    QList<QDropboxIndexEntry> findByExtension(const QString& extension, const int& limit = 100) const;
+    QList<QDropboxIndexEntry> findUnder(const QString& path, const bool& recursive = true, const int& limit = -1) const;
+
+public slots:
+    void add(const QList<QDropboxFile*>& files);
+    void remove(const QStringList& paths);
+    void clear();
+
+private slots:
+    void onListFolderLoaded(const QString& path, QList<QDropboxFile*>& files, const QString& cursor, const bool& hasMore);
+    void onListFolderContinueLoaded(QList<QDropboxFile*>& files, const QString& prevCursor, const QString& cursor, const bool& hasMore);
+
+private:
+    QMap<QString, QDropboxIndexEntry> m_entries;
+    QMap<QString, QString> m_words;
+    QHash<QString, QSet<QString> > m_extensions;
+
+    void insert(const QDropboxIndexEntry& entry);
+    void erase(const QString& pathLower);
+    static QStringList words(const QString& name);
+    static QString extension(const QString& name);
+    static QString wordKey(const QString& word, const QString& pathLower);
+};
+
+#endif /* QDROPBOXSEARCHINDEX_HPP_ */
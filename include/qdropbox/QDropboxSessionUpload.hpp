@@ -0,0 +1,69 @@
+/*
+ * QDropboxSessionUpload.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#ifndef QDROPBOXSESSIONUPLOAD_HPP_
+#define QDROPBOXSESSIONUPLOAD_HPP_
+
+#include <QObject>
+#include <QFile>
+#include <QVariant>
+#include <QNetworkReply>
+
+#include "QDropbox.hpp"
+#include "Logger.hpp"
+
+/**
+ * Uploads one local file through an upload session: start, append and finish, one chunk after another.
+ * Files not larger than one chunk go through a single upload call instead.
+ */
+class QDropboxSessionUpload : public QObject {
+    Q_OBJECT
+public:
+    QDropboxSessionUpload(QDropbox* dropbox, const QString& localPath, const QString& remotePath, const QString& mode = "add", QObject* parent = 0);
+    virtual ~QDropboxSessionUpload();
+
+    const QString& getLocalPath() const;
+    const QString& getRemotePath() const;
+
+    const qint64& getChunkSize() const;
+    QDropboxSessionUpload& setChunkSize(const qint64& chunkSize);
+
+    bool start();
+
+public slots:
+    void cancel();
+
+Q_SIGNALS:
+    void progress(qint64 sent, qint64 total);
+    void finished(const QVariant& metadata);
+    void failed(const QString& reason);
+
+private slots:
+    void onStarted(const QVariant& value);
+    void onAppended(const QVariant& value);
+    void onFinished(const QVariant& value);
+    void onFailed(QNetworkReply::NetworkError e, const QString& errorString);
+
+private:
+    static Logger logger;
+
+    QDropbox* m_pDropbox;
+    QFile m_file;
+    QString m_localPath;
+    QString m_remotePath;
+    QString m_mode;
+    qint64 m_chunkSize;
+    QString m_sessionId;
+    qint64 m_offset;
+    qint64 m_sending;
+    QDropboxRequest* m_pRequest;
+
+    void next();
+    void fail(const QString& reason);
+};
+
+#endif /* QDROPBOXSESSIONUPLOAD_HPP_ */
@@ -0,0 +1,73 @@
+/*
+ * QDropboxShardedListing.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#ifndef QDROPBOXSHARDEDLISTING_HPP_
+#define QDROPBOXSHARDEDLISTING_HPP_
+
+#include <QObject>
+#include <QList>
+#include <QMap>
+#include <QSet>
+#include <QStringList>
+
+#include "QDropbox.hpp"
+#include "QDropboxFile.hpp"
+#include "Logger.hpp"
+
+/**
+ * Recursive listing split into shards: the top level is listed once, then every top-level folder
+ * is listed recursively on its own, at most concurrency shards at a time. The snapshot is described
+ * by one cursor per shard plus the non-recursive cursor of the top level.
+ */
+class QDropboxShardedListing : public QObject {
+    Q_OBJECT
+public:
+    QDropboxShardedListing(QDropbox* dropbox, QObject* parent = 0);
+    virtual ~QDropboxShardedListing();
+
+    const int& getConcurrency() const;
+    QDropboxShardedListing& setConcurrency(const int& concurrency);
+
+    const QString& getPath() const;
+    const QList<QDropboxFile*>& getFiles() const;
+    const QMap<QString, QString>& getCursors() const;
+    bool isRunning() const;
+
+public slots:
+    void start(const QString& path = "", const bool& includeMediaInfo = false);
+
+Q_SIGNALS:
+    void pageLoaded(const QString& shard, const QList<QDropboxFile*>& files);
+    void finished(const QList<QDropboxFile*>& files, const QMap<QString, QString>& cursors);
+    void failed(const QString& shard, QNetworkReply::NetworkError e, const QString& errorString);
+
+private slots:
+    void onListFolderPageLoaded(const QString& path, QList<QDropboxFile*>& files, const QString& cursor, const bool& hasMore);
+    void onListFolderPagingFinished(const QString& path, const QString& cursor);
+    void onListFolderPagingFailed(const QString& path, QNetworkReply::NetworkError e, const QString& errorString);
+
+private:
+    static Logger logger;
+
+    QDropbox* m_pDropbox;
+    QString m_path;
+    bool m_includeMediaInfo;
+    int m_concurrency;
+    bool m_running;
+    bool m_topLevelListed;
+
+    QStringList m_pendingShards;
+    QSet<QString> m_runningShards;
+    QMap<QString, int> m_pagingIds;
+    QList<QDropboxFile*> m_files;
+    QMap<QString, QString> m_cursors;
+
+    void list(const QString& path, const bool& recursive);
+    void next();
+};
+
+#endif /* QDROPBOXSHARDEDLISTING_HPP_ */
@@ -0,0 +1,170 @@
+/*
+ * QDropboxSyncEngine.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#ifndef QDROPBOXSYNCENGINE_HPP_
+#define QDROPBOXSYNCENGINE_HPP_
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+#include <QDataStream>
+#include <QNetworkReply>
+
+#include "QDropbox.hpp"
+#include "QDropboxFile.hpp"
+#include "QDropboxSessionUpload.hpp"
+#include "QDropboxLocalScanner.hpp"
+#include "Logger.hpp"
+
+struct SyncEntry {
+    SyncEntry() : folder(false), size(0), modified(0) {}
+
+    QString path;
+    bool folder;
+    qint64 size;
+    qint64 modified;
+    QString contentHash;
+    QString rev;
+};
+
+/**
+ * Keeps a local folder and a Dropbox folder in step. Every sync walks the local tree in parallel and
+ * pages the remote listing from the saved cursor, then reconciles both against the state of the last sync:
+ * a side that did not change since then follows the one that did. Files changed on both sides keep both versions,
+ * the local one as a conflicted copy. Files with the same content hash that disappeared at one path and appeared
+ * at another are moved instead of transferred again.
+ *
+ * Local changes are applied right away, remote moves and deletes go through the batch endpoints,
+ * uploads and downloads run with bounded concurrency. The state is saved after every completed operation,
+ * so a sync interrupted at any point resumes incrementally.
+ */
+class QDropboxSyncEngine : public QObject {
+    Q_OBJECT
+public:
+    QDropboxSyncEngine(QDropbox* dropbox, const QString& localPath, const QString& remotePath, const QString& statePath, QObject* parent = 0);
+    virtual ~QDropboxSyncEngine();
+
+    const QString& getLocalPath() const;
+    const QString& getRemotePath() const;
+    const QString& getStatePath() const;
+
+    const int& getConcurrency() const;
+    QDropboxSyncEngine& setConcurrency(const int& concurrency);
+
+    bool isRunning() const;
+
+public slots:
+    void sync();
+    void stop();
+
+Q_SIGNALS:
+    void planned(int operations);
+    void progress(int done, int total);
+    void synced();
+    void failed(const QString& reason);
+
+private slots:
+    void onScanned();
+    void onListFolderLoaded(const QString& path, QList<QDropboxFile*>& files, const QString& cursor, const bool& hasMore);
+    void onListFolderContinueLoaded(QList<QDropboxFile*>& files, const QString& prevCursor, const QString& cursor, const bool& hasMore);
+    void onListingFailed(QNetworkReply::NetworkError e, const QString& errorString);
+    void onBatchLaunched(const QVariant& value);
+    void onBatchFailed(QNetworkReply::NetworkError e, const QString& errorString);
+    void onJobFinished(const AsyncJobStatus& status);
+    void onTransferred(const QVariant& value);
+    void onTransferFailed(QNetworkReply::NetworkError e, const QString& errorString);
+    void onUploaded(const QVariant& metadata);
+    void onUploadFailed(const QString& reason);
+    void save();
+
+private:
+    enum State {
+        Idle,
+        Scanning,
+        Moving,
+        Deleting,
+        Transferring
+    };
+
+    struct Operation {
+        enum Kind {
+            Upload,
+            Download,
+            CreateFolder
+        };
+
+        Operation() : kind(Upload) {}
+
+        Kind kind;
+        QString key;
+        QString mode;
+        SyncEntry entry;
+    };
+
+    struct Move {
+        QString fromKey;
+        QString toKey;
+        QString toPath;
+        SyncEntry entry;
+    };
+
+    static Logger logger;
+
+    QDropbox* m_pDropbox;
+    QString m_localPath;
+    QString m_remotePath;
+    QString m_statePath;
+    int m_concurrency;
+    State m_state;
+    QString m_cursor;
+    bool m_listing;
+    bool m_relisted;
+    QList<QDropboxLocalScanner*> m_scanners;
+    QHash<QString, SyncEntry> m_local;
+    QHash<QString, SyncEntry> m_remote;
+    QHash<QString, SyncEntry> m_base;
+
+    QList<Move> m_moves;
+    QStringList m_deletes;
+    QList<Move> m_batchMoves;
+    QStringList m_batchDeletes;
+    QString m_jobId;
+    QList<Operation> m_queue;
+    QHash<QDropboxRequest*, Operation> m_transfers;
+    QHash<QDropboxSessionUpload*, Operation> m_uploads;
+    int m_done;
+    int m_total;
+    int m_failures;
+    QTimer m_saveTimer;
+
+    void list();
+    void reconcile();
+    void nextBatch();
+    void batchDone(const QVariantList& entries, const bool& ok);
+    void pump();
+    bool start(const Operation& operation);
+    void done(const bool& ok);
+    void finish();
+    void load();
+    void writeEntries(QDataStream& out, const QHash<QString, SyncEntry>& entries) const;
+    void readEntries(QDataStream& in, QHash<QString, SyncEntry>& entries) const;
+    QString localFilePath(const QString& path) const;
+    QString remoteFilePath(const QString& path) const;
+
+    static bool same(const SyncEntry& a, const SyncEntry& b);
+    static void addAncestors(QSet<QString>& keys, const QString& key);
+    static bool hasAncestor(const QSet<QString>& keys, const QString& key);
+    static void removeTree(QHash<QString, SyncEntry>& entries, const QString& key);
+    static bool removeLocal(const QString& path);
+    static QString conflictedCopy(const QString& path);
+};
+
+#endif /* QDROPBOXSYNCENGINE_HPP_ */
@@ -0,0 +1,85 @@
+/*
+ * QDropboxThumbnailCache.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#ifndef QDROPBOXTHUMBNAILCACHE_HPP_
+#define QDROPBOXTHUMBNAILCACHE_HPP_
+
+#include <QObject>
+#include <QCache>
+#include <QHash>
+#include <QMultiHash>
+#include <QList>
+#include <QTimer>
+#include <QtGui/QImage>
+
+#include "QDropboxFile.hpp"
+#include "Logger.hpp"
+
+/**
+ * Two tier thumbnail cache keyed by path, rev, size and format. Decoded images live in a memory LRU
+ * bounded by bytes, the encoded payloads as received from Dropbox live in a directory with an index file.
+ * Only the memory tier is served synchronously, a disk hit hands back the payload to be decoded off the main thread.
+ * Entries of a path are dropped as soon as a listing reports a new rev for it, entries below a deleted folder with it.
+ */
+class QDropboxThumbnailCache : public QObject {
+    Q_OBJECT
+public:
+    QDropboxThumbnailCache(const QString& directory, QObject* parent = 0);
+    virtual ~QDropboxThumbnailCache();
+
+    const QString& getDirectory() const;
+
+    int getMaxMemory() const;
+    QDropboxThumbnailCache& setMaxMemory(const int& maxMemory);
+
+    const qint64& getMaxDisk() const;
+    QDropboxThumbnailCache& setMaxDisk(const qint64& maxDisk);
+
+    QString revision(const QString& path) const;
+
+    QImage* find(const QString& path, const QString& size, const QString& format);
+    QByteArray findData(const QString& path, const QString& size, const QString& format);
+    void insert(const QString& path, const QString& size, const QString& format, const QByteArray& data, const QImage& image);
+    void remove(const QString& path, const QString& size, const QString& format);
+    void invalidate(const QString& path);
+    void clear();
+
+public slots:
+    void update(const QList<QDropboxFile*>& files);
+    void save();
+
+private:
+    struct DiskEntry {
+        DiskEntry() : size(0), lastUsed(0) {}
+
+        QString path;
+        QString rev;
+        QString filename;
+        qint64 size;
+        uint lastUsed;
+    };
+
+    static Logger logger;
+
+    QString m_directory;
+    QCache<QString, QImage> m_memory;
+    QHash<QString, DiskEntry> m_disk;
+    QMultiHash<QString, QString> m_keysByPath;
+    QHash<QString, QString> m_revs;
+    qint64 m_diskUsage;
+    qint64 m_maxDisk;
+    QTimer m_saveTimer;
+
+    QString key(const QString& path, const QString& size, const QString& format) const;
+    void load();
+    void sweep();
+    void removeDiskEntry(const QString& key);
+    void evictDisk();
+    void scheduleSave();
+};
+
+#endif /* QDROPBOXTHUMBNAILCACHE_HPP_ */
@@ -0,0 +1,78 @@
+/*
+ * QDropboxThumbnailDecoder.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#ifndef QDROPBOXTHUMBNAILDECODER_HPP_
+#define QDROPBOXTHUMBNAILDECODER_HPP_
+
+#include <QObject>
+#include <QRunnable>
+#include <QByteArray>
+#include <QList>
+#include <QVariantList>
+#include <QSize>
+#include <QMutex>
+#include <QtGui/QImage>
+
+#include "Logger.hpp"
+
+struct DecodedThumbnail {
+    QString key;
+    QString path;
+    QString size;
+    QString format;
+    QByteArray data;
+    QImage image;
+    QString errorString;
+};
+
+/**
+ * Decodes thumbnails on a pool thread. In Batch mode the data is a get_thumbnail_batch response which is parsed
+ * and base64 decoded first, in Single mode it is the raw get_thumbnail payload for the only entry.
+ * Images are decoded directly at the scaled size when one is set, into pixel buffers taken from a shared pool.
+ * Only images nobody else shares go back to the pool, the cache keeps a copy of its own for that reason.
+ * Results are collected by the receiver of decoded(), entries that could not be fetched or decoded carry an errorString.
+ */
+class QDropboxThumbnailDecoder : public QObject, public QRunnable {
+    Q_OBJECT
+public:
+    enum Mode {
+        Batch,
+        Single
+    };
+
+    QDropboxThumbnailDecoder(const QByteArray& data, const QVariantList& entries, const Mode& mode = Batch, QObject* parent = 0);
+    virtual ~QDropboxThumbnailDecoder();
+
+    void run();
+
+    const QSize& getScaledSize() const;
+    QDropboxThumbnailDecoder& setScaledSize(const QSize& scaledSize);
+
+    const QList<DecodedThumbnail>& getThumbnails() const;
+
+    static void recycle(QImage* image);
+
+Q_SIGNALS:
+    void decoded();
+
+private:
+    static Logger logger;
+    static QMutex m_poolMutex;
+    static QList<QImage> m_pool;
+
+    QByteArray m_data;
+    QVariantList m_entries;
+    Mode m_mode;
+    QSize m_scaledSize;
+    QList<DecodedThumbnail> m_thumbnails;
+
+    void decode(const QVariantMap& entry, const QByteArray& data);
+    void fail(const QVariantMap& entry, const QString& errorString);
+    static QImage acquire(const QSize& size);
+};
+
+#endif /* QDROPBOXTHUMBNAILDECODER_HPP_ */
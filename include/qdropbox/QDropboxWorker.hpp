@@ -0,0 +1,63 @@
+/*
+ * QDropboxWorker.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#ifndef QDROPBOXWORKER_HPP_
+#define QDROPBOXWORKER_HPP_
+
+#include <QObject>
+#include <QList>
+#include <QVariantMap>
+#include <QNetworkReply>
+
+#include "QDropbox.hpp"
+#include "QDropboxFile.hpp"
+#include "QDropboxTempLink.hpp"
+
+/**
+ * Lives on one thread of a QDropboxConcurrentClient and owns the QDropbox of that thread, which is
+ * created in start() so that its network manager and timers belong to the worker thread.
+ * All slots are meant to be invoked queued. The listing signals of the QDropbox pass the files by
+ * non-const reference, which cannot be queued, so they are re-emitted here with const arguments.
+ */
+class QDropboxWorker : public QObject {
+    Q_OBJECT
+public:
+    QDropboxWorker(QObject* parent = 0);
+    virtual ~QDropboxWorker();
+
+    QDropbox* getDropbox() const;
+
+public slots:
+    void start(const QVariantMap& configuration);
+    void stop();
+    void configure(const QVariantMap& configuration);
+
+    void getMetadata(const QString& path, const bool& includeMediaInfo);
+    void listFolder(const QString& path, const bool& includeMediaInfo, const bool& recursive);
+    void listFolderContinue(const QString& cursor);
+    void getThumbnail(const QString& path, const QString& size, const QString& format);
+    void getTemporaryLink(const QString& path);
+    void download(const QString& path, const QString& rev);
+    void upload(const QString& localPath, const QString& remotePath, const QString& mode);
+    void createFolder(const QString& path, const bool& autorename);
+    void deleteFile(const QString& path);
+    void move(const QString& fromPath, const QString& toPath);
+    void copy(const QString& fromPath, const QString& toPath);
+
+Q_SIGNALS:
+    void listFolderLoaded(const QString& path, const QList<QDropboxFile*>& files, const QString& cursor, const bool& hasMore);
+    void listFolderContinueLoaded(const QList<QDropboxFile*>& files, const QString& prevCursor, const QString& cursor, const bool& hasMore);
+
+private slots:
+    void onListFolderLoaded(const QString& path, QList<QDropboxFile*>& files, const QString& cursor, const bool& hasMore);
+    void onListFolderContinueLoaded(QList<QDropboxFile*>& files, const QString& prevCursor, const QString& cursor, const bool& hasMore);
+
+private:
+    QDropbox* m_pDropbox;
+};
+
+#endif /* QDROPBOXWORKER_HPP_ */
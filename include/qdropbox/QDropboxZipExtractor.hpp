@@ -0,0 +1,77 @@
+/*
+ * QDropboxZipExtractor.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#ifndef QDROPBOXZIPEXTRACTOR_HPP_
+#define QDROPBOXZIPEXTRACTOR_HPP_
+
+#include <QIODevice>
+#include <QByteArray>
+#include <QFile>
+#include <QStringList>
+
+struct z_stream_s;
+
+/**
+ * Write only device extracting a zip archive into a directory while it is written, without keeping the archive.
+ * Entries are read from their local headers, so the archive is never seeked. Stored and deflated entries are supported,
+ * names leaving the directory are skipped. Extraction stops at the central directory, see isComplete().
+ */
+class QDropboxZipExtractor : public QIODevice {
+    Q_OBJECT
+public:
+    QDropboxZipExtractor(const QString& directory, QObject* parent = 0);
+    virtual ~QDropboxZipExtractor();
+
+    const QString& getDirectory() const;
+
+    const int& getStripComponents() const;
+    QDropboxZipExtractor& setStripComponents(const int& stripComponents);
+
+    const QStringList& getFiles() const;
+    const qint64& getExtracted() const;
+    bool isComplete() const;
+
+    bool isSequential() const;
+    void close();
+
+protected:
+    qint64 readData(char* data, qint64 maxSize);
+    qint64 writeData(const char* data, qint64 size);
+
+private:
+    enum State {
+        Header,
+        Data,
+        Descriptor,
+        Done,
+        Failed
+    };
+
+    QString m_directory;
+    int m_stripComponents;
+    QStringList m_files;
+    qint64 m_extracted;
+    State m_state;
+    QByteArray m_buffer;
+    QFile* m_pFile;
+    QString m_current;
+    z_stream_s* m_pStream;
+    quint16 m_flags;
+    quint16 m_method;
+    qint64 m_remaining;
+    bool m_zip64;
+
+    bool readHeader();
+    bool inflateData();
+    bool copyData();
+    bool readDescriptor();
+    void closeEntry();
+    void fail(const QString& reason);
+    QString target(const QString& name) const;
+};
+
+#endif /* QDROPBOXZIPEXTRACTOR_HPP_ */
@@ -18,4 +18,5 @@ include(config.pri)
 # uncomment following line to include translations to binary
 # RESOURCES += translations/qm/qdropbox_translations.qrc
 
-QT += network core gui
\ No newline at end of file
+QT += network core gui
+LIBS += -lz
\ No newline at end of file
@@ -16,4 +16,4 @@ simulator {
 BASEDIR      = $${PWD}
 INCLUDEPATH *= $$quote($${BASEDIR}/include)
 DEPENDPATH  *= $$quote($${BASEDIR}/include)
-LIBS        += -L$${BASEDIR}/$${LIBTARGETDIR} -l$${LIBTARGET}
+LIBS        += -L$${BASEDIR}/$${LIBTARGETDIR} -l$${LIBTARGET} -lz
@@ -10,9 +10,15 @@
 #include <QDebug>
 #include <QList>
 #include <QDir>
+#include <QFileInfo>
+#include <QThreadPool>
+#include <QDateTime>
 #include "../qjson/serializer.h"
 #include "../qjson/parser.h"
+#include "../qjson/parserrunnable.h"
 #include "../../include/qdropbox/QDropboxFile.hpp"
+#include "../../include/qdropbox/QDropboxJobTracker.hpp"
+#include "../../include/qdropbox/QDropboxRateLimiter.hpp"
 #include "../../include/qdropbox/QDropboxCommon.hpp"
 
 Logger QDropbox::logger = Logger::getLogger("QDropbox");
@@ -21,6 +27,19 @@ qint64 QDropbox::uploadSize = 157286400; // 150MB
 #define DROPBOX_UPLOAD_SIZE 157286400 // 150 MB
 #define UPLOAD_SIZE 1048576 // 1 MB
 #define CONCURRENT_UPLOADS 5
+#define THUMBNAIL_BATCH_SIZE 25 // max allowed by Dropbox
+#define THUMBNAIL_BATCH_WINDOW 50
+#define WRITE_BATCH_SIZE 1000 // max allowed by Dropbox
+#define WRITE_COMBINE_WINDOW 200
+#define MAX_RETRIES 5
+#define REQUEST_TIMEOUT 60000
+#define STALL_TIMEOUT 60000
+#define WATCHDOG_INTERVAL 1000
+#define LONGPOLL_JITTER 90 // Dropbox adds up to 90 seconds to the longpoll timeout
+#define RETRY_BASE_DELAY 1000
+#define RETRY_MAX_DELAY 60000
+#define SINK_BUFFER_SIZE 1048576 // 1 MB
+#define SINK_CHUNK_SIZE 65536
 
 QDropbox::QDropbox(QObject* parent) : QObject(parent) {
     init();
@@ -38,7 +57,10 @@ QDropbox::QDropbox(const QString& appSecret, const QString& appKey, const QStrin
     m_redirectUri = redirectUri;
 }
 
-QDropbox::~QDropbox() {}
+QDropbox::~QDropbox() {
+    qDeleteAll(m_pagings);
+    m_pagings.clear();
+}
 
 const QString& QDropbox::getUrl() const { return m_url; }
 QDropbox& QDropbox::setUrl(const QString& url) {
@@ -92,19 +114,152 @@ QDropbox& QDropbox::setReadBufferSize(qint64 readBufferSize) {
     return *this;
 }
 
+const int& QDropbox::getMaxBufferedPages() const { return m_maxBufferedPages; }
+QDropbox& QDropbox::setMaxBufferedPages(const int& maxBufferedPages) {
+    m_maxBufferedPages = qMax(1, maxBufferedPages);
+    return *this;
+}
+
+const bool& QDropbox::isCoalesceRequests() const { return m_coalesceRequests; }
+QDropbox& QDropbox::setCoalesceRequests(const bool& coalesceRequests) {
+    m_coalesceRequests = coalesceRequests;
+    return *this;
+}
+
+QDropboxThumbnailCache* QDropbox::getThumbnailCache() const { return m_pThumbnailCache; }
+QDropbox& QDropbox::setThumbnailCache(QDropboxThumbnailCache* thumbnailCache) {
+    m_pThumbnailCache = thumbnailCache;
+    return *this;
+}
+
+QDropboxBlockStore* QDropbox::getBlockStore() const { return m_pBlockStore; }
+QDropbox& QDropbox::setBlockStore(QDropboxBlockStore* blockStore) {
+    if (m_pBlockStore != 0) {
+        m_pBlockStore->disconnect(this);
+    }
+    m_pBlockStore = blockStore;
+    if (m_pBlockStore != 0) {
+        bool res = QObject::connect(m_pBlockStore, SIGNAL(materialized(const QString&, const bool&)), this, SLOT(onMaterialized(const QString&, const bool&)));
+        Q_ASSERT(res);
+        Q_UNUSED(res);
+    }
+    return *this;
+}
+
+const bool& QDropbox::isThumbnailBatching() const { return m_thumbnailBatching; }
+QDropbox& QDropbox::setThumbnailBatching(const bool& thumbnailBatching) {
+    m_thumbnailBatching = thumbnailBatching;
+    if (!m_thumbnailBatching && m_pendingThumbnails.size()) {
+        flushThumbnailBatch();
+    }
+    return *this;
+}
+
+int QDropbox::getThumbnailBatchWindow() const { return m_thumbnailBatchTimer.interval(); }
+QDropbox& QDropbox::setThumbnailBatchWindow(const int& msec) {
+    m_thumbnailBatchTimer.setInterval(msec);
+    return *this;
+}
+
+const QSize& QDropbox::getThumbnailScaledSize() const { return m_thumbnailScaledSize; }
+QDropbox& QDropbox::setThumbnailScaledSize(const QSize& thumbnailScaledSize) {
+    m_thumbnailScaledSize = thumbnailScaledSize;
+    return *this;
+}
+
+const bool& QDropbox::isWriteCombining() const { return m_writeCombining; }
+QDropbox& QDropbox::setWriteCombining(const bool& writeCombining) {
+    m_writeCombining = writeCombining;
+    if (!m_writeCombining) {
+        flushWrites();
+    }
+    return *this;
+}
+
+int QDropbox::getWriteCombineWindow() const { return m_writeCombineTimer.interval(); }
+QDropbox& QDropbox::setWriteCombineWindow(const int& msec) {
+    m_writeCombineTimer.setInterval(msec);
+    return *this;
+}
+
+QNetworkAccessManager* QDropbox::getNetworkAccessManager() const { return m_pNetwork; }
+QDropbox& QDropbox::setNetworkAccessManager(QNetworkAccessManager* network) {
+    if (network == 0 || network == m_pNetwork) {
+        return *this;
+    }
+    if (m_pNetwork->parent() == this) {
+        m_pNetwork->deleteLater();
+    }
+    m_pNetwork = network;
+    return *this;
+}
+
+int QDropbox::getKeepWarmInterval() const { return m_keepWarmTimer.isActive() ? m_keepWarmTimer.interval() : 0; }
+QDropbox& QDropbox::setKeepWarmInterval(const int& msec) {
+    if (msec > 0) {
+        m_keepWarmTimer.start(msec);
+    } else {
+        m_keepWarmTimer.stop();
+    }
+    return *this;
+}
+
+const bool& QDropbox::isHttp2Allowed() const { return m_http2Allowed; }
+QDropbox& QDropbox::setHttp2Allowed(const bool& http2Allowed) {
+    m_http2Allowed = http2Allowed;
+    return *this;
+}
+
+int QDropbox::getMaxConnectionsPerHost(const QString& host) const {
+    return m_hostLimits.value(host, m_maxConnectionsPerHost);
+}
+
+QDropbox& QDropbox::setMaxConnectionsPerHost(const int& maxConnections) {
+    m_maxConnectionsPerHost = maxConnections;
+    return *this;
+}
+
+QDropbox& QDropbox::setMaxConnectionsPerHost(const QString& host, const int& maxConnections) {
+    m_hostLimits.insert(host, maxConnections);
+    return *this;
+}
+
+const int& QDropbox::getRequestTimeout() const { return m_requestTimeout; }
+QDropbox& QDropbox::setRequestTimeout(const int& requestTimeout) {
+    m_requestTimeout = requestTimeout;
+    return *this;
+}
+
+const int& QDropbox::getStallTimeout() const { return m_stallTimeout; }
+QDropbox& QDropbox::setStallTimeout(const int& stallTimeout) {
+    m_stallTimeout = stallTimeout;
+    return *this;
+}
+
+const int& QDropbox::getMaxRetries() const { return m_maxRetries; }
+QDropbox& QDropbox::setMaxRetries(const int& maxRetries) {
+    m_maxRetries = maxRetries;
+    return *this;
+}
+
+double QDropbox::getRequestRate() const {
+    QSharedPointer<QDropboxRateLimiter> limiter = QDropboxRateLimiter::forNamespace(m_accessToken);
+    return limiter->getRate();
+}
+QDropbox& QDropbox::setRequestRate(const double& requestsPerSecond, const int& burst) {
+    QSharedPointer<QDropboxRateLimiter> limiter = QDropboxRateLimiter::forNamespace(m_accessToken);
+    limiter->setRate(requestsPerSecond, burst);
+    return *this;
+}
+
 QString QDropbox::authUrl() const {
     return QString(m_authUrl).append("/authorize?response_type=token&client_id=").append(m_appKey).append("&redirect_uri=").append(m_redirectUri);
 }
 
-void QDropbox::authTokenRevoke() {
+QDropboxRequest* QDropbox::authTokenRevoke() {
     QNetworkRequest req = prepareRequest("/auth/token/revoke");
 
-    QNetworkReply* reply = m_network.post(req, "");
-    bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onAuthTokenRevoked()));
-    Q_ASSERT(res);
-    res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
-    Q_ASSERT(res);
-    Q_UNUSED(res);
+    return send(req, "", SLOT(onAuthTokenRevoked()));
 }
 
 void QDropbox::onAuthTokenRevoked() {
@@ -117,7 +272,7 @@ void QDropbox::onAuthTokenRevoked() {
     reply->deleteLater();
 }
 
-void QDropbox::listFolder(const QString& path, const bool& includeMediaInfo, const bool& recursive,
+QDropboxRequest* QDropbox::listFolder(const QString& path, const bool& includeMediaInfo, const bool& recursive,
                     const bool& includeDeleted, const bool& includeHasExplicitSharedMembers, const bool& includeMountedFolders,
                     const int& limit, SharedLink sharedLink) {
 
@@ -136,13 +291,9 @@ void QDropbox::listFolder(const QString& path, const bool& includeMediaInfo, con
     map["include_has_explicit_shared_members"] = includeHasExplicitSharedMembers;
     map["include_mounted_folders"] = includeMountedFolders;
 
-    QNetworkReply* reply = m_network.post(req, QJson::Serializer().serialize(map));
-    reply->setProperty("path", path);
-    bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onListFolderLoaded()));
-    Q_ASSERT(res);
-    res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
-    Q_ASSERT(res);
-    Q_UNUSED(res);
+    QDropboxRequest* request = send(req, QJson::Serializer().serialize(map), SLOT(onListFolderLoaded()));
+    request->getContext().path = path;
+    return request;
 }
 
 void QDropbox::onListFolderLoaded() {
@@ -162,7 +313,10 @@ void QDropbox::onListFolderLoaded() {
                 pFile->fromMap(v.toMap());
                 files.append(pFile);
             }
-            QString path = reply->property("path").toString();
+            if (m_pThumbnailCache != 0) {
+                m_pThumbnailCache->update(files);
+            }
+            QString path = context().path;
             emit listFolderLoaded(path, files, cursor, hasMore);
         }
     }
@@ -170,18 +324,14 @@ void QDropbox::onListFolderLoaded() {
     reply->deleteLater();
 }
 
-void QDropbox::listFolderContinue(const QString& cursor) {
+QDropboxRequest* QDropbox::listFolderContinue(const QString& cursor) {
     QNetworkRequest req = prepareRequest("/files/list_folder/continue");
     QVariantMap map;
     map["cursor"] = cursor;
 
-    QNetworkReply* reply = m_network.post(req, QJson::Serializer().serialize(map));
-    reply->setProperty("cursor", cursor);
-    bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onListFolderContinueLoaded()));
-    Q_ASSERT(res);
-    res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
-    Q_ASSERT(res);
-    Q_UNUSED(res);
+    QDropboxRequest* request = send(req, QJson::Serializer().serialize(map), SLOT(onListFolderContinueLoaded()));
+    request->getContext().cursor = cursor;
+    return request;
 
 }
 
@@ -202,7 +352,10 @@ void QDropbox::onListFolderContinueLoaded() {
                 pFile->fromMap(v.toMap());
                 files.append(pFile);
             }
-            QString prevCursor = reply->property("cursor").toString();
+            if (m_pThumbnailCache != 0) {
+                m_pThumbnailCache->update(files);
+            }
+            QString prevCursor = context().cursor;
             emit listFolderContinueLoaded(files, prevCursor, cursor, hasMore);
         }
     }
@@ -210,7 +363,229 @@ void QDropbox::onListFolderContinueLoaded() {
     reply->deleteLater();
 }
 
-void QDropbox::listFolderLongPoll(const QString& cursor, const int& timeout) {
+QDropboxRequest* QDropbox::listFolderPaged(const QString& path, const bool& includeMediaInfo, const bool& recursive, const bool& includeDeleted, const int& limit) {
+    QNetworkRequest req = prepareRequest("/files/list_folder");
+    QVariantMap map;
+    if (limit != 0) {
+        map["limit"] = limit;
+    }
+    map["path"] = path;
+    map["include_media_info"] = includeMediaInfo;
+    map["recursive"] = recursive;
+    map["include_deleted"] = includeDeleted;
+
+    int pagingId = ++m_pagingId;
+    ListFolderPaging* paging = new ListFolderPaging(path);
+    paging->token = token();
+    paging->fetching = true;
+    m_pagings.insert(pagingId, paging);
+
+    QDropboxRequest* request = send(req, QJson::Serializer().serialize(map), SLOT(onListFolderPageLoaded()));
+    request->getContext().pagingId = pagingId;
+    request->getContext().page = paging->requested++;
+    return request;
+}
+
+void QDropbox::cancelListFolderPaging(const int& pagingId) {
+    ListFolderPaging* paging = m_pagings.take(pagingId);
+    if (paging == 0) {
+        return;
+    }
+    delete paging;
+
+    // a page already decoding is dropped once its paging is gone
+    QList<QDropboxRequest*> requests = m_pendingRequests + m_requests.values();
+    foreach(QDropboxRequest* request, requests) {
+        if (request->getContext().pagingId == pagingId) {
+            request->cancel();
+        }
+    }
+}
+
+void QDropbox::fetchNextPage(const int& pagingId) {
+    ListFolderPaging* paging = m_pagings.value(pagingId, 0);
+    if (paging == 0 || paging->fetching || paging->done || paging->nextCursor.isEmpty()) {
+        return;
+    }
+    if (paging->requested - paging->emitted >= m_maxBufferedPages) {
+        return;
+    }
+
+    // pages are fetched on the account the paging was started on, whichever one the client holds now
+    QString scopedToken = m_scopedToken;
+    m_scopedToken = paging->token;
+    QNetworkRequest req = prepareRequest("/files/list_folder/continue");
+    QVariantMap map;
+    map["cursor"] = paging->nextCursor;
+    paging->nextCursor = "";
+    paging->fetching = true;
+
+    QDropboxRequest* request = send(req, QJson::Serializer().serialize(map), SLOT(onListFolderPageLoaded()));
+    request->getContext().pagingId = pagingId;
+    request->getContext().page = paging->requested++;
+    m_scopedToken = scopedToken;
+}
+
+void QDropbox::onListFolderPageLoaded() {
+    QNetworkReply* reply = getReply();
+    int pagingId = context().pagingId;
+    int page = context().page;
+    ListFolderPaging* paging = m_pagings.value(pagingId, 0);
+
+    if (paging != 0) {
+        paging->fetching = false;
+        if (reply->error() == QNetworkReply::NoError) {
+            QByteArray data = reply->readAll();
+
+            // cursor and has_more are picked from the top level without decoding, so the next page
+            // can go out before this one is decoded
+            QString cursor;
+            bool hasMore = false;
+            if (peekCursor(data, cursor, hasMore)) {
+                if (hasMore) {
+                    paging->nextCursor = cursor;
+                    fetchNextPage(pagingId);
+                } else {
+                    paging->done = true;
+                }
+            }
+
+            QJson::ParserRunnable* parser = new QJson::ParserRunnable();
+            parser->setAutoDelete(false);
+            parser->setData(data);
+            parser->setProperty("paging_id", pagingId);
+            parser->setProperty("page", page);
+            bool res = QObject::connect(parser, SIGNAL(parsingFinished(const QVariant&, bool, const QString&)),
+                    this, SLOT(onListFolderPageParsed(const QVariant&, bool, const QString&)));
+            Q_ASSERT(res);
+            Q_UNUSED(res);
+            QThreadPool::globalInstance()->start(parser);
+        } else {
+            QString path = paging->path;
+            m_pagings.remove(pagingId);
+            delete paging;
+            emit listFolderPagingFailed(path, reply->error(), reply->errorString());
+        }
+    }
+
+    reply->deleteLater();
+}
+
+void QDropbox::onListFolderPageParsed(const QVariant& json, bool ok, const QString& errorMessage) {
+    QObject* parser = QObject::sender();
+    int pagingId = parser->property("paging_id").toInt();
+    int page = parser->property("page").toInt();
+    parser->deleteLater();
+
+    ListFolderPaging* paging = m_pagings.value(pagingId, 0);
+    if (paging == 0) {
+        return;
+    }
+
+    if (!ok) {
+        logger.error("Cannot parse list_folder page: " + errorMessage);
+        QString path = paging->path;
+        m_pagings.remove(pagingId);
+        delete paging;
+        emit listFolderPagingFailed(path, QNetworkReply::UnknownContentError, errorMessage);
+        return;
+    }
+
+    paging->decoded.insert(page, json);
+    while (paging->decoded.contains(paging->emitted)) {
+        int current = paging->emitted++;
+        QVariantMap dataMap = paging->decoded.take(current).toMap();
+        QString cursor = dataMap.value("cursor").toString();
+        bool hasMore = dataMap.value("has_more").toBool();
+        paging->lastCursor = cursor;
+
+        if (current + 1 == paging->requested && !paging->fetching) {
+            if (hasMore) {
+                paging->nextCursor = cursor;
+            } else {
+                paging->done = true;
+            }
+        }
+
+        QList<QDropboxFile*> files;
+        foreach(QVariant v, dataMap.value("entries").toList()) {
+            QDropboxFile* pFile = new QDropboxFile(this);
+            pFile->fromMap(v.toMap());
+            files.append(pFile);
+        }
+        if (m_pThumbnailCache != 0) {
+            m_pThumbnailCache->update(files);
+        }
+        QString path = paging->path;
+        emit listFolderPageLoaded(path, files, cursor, hasMore);
+
+        if (!m_pagings.contains(pagingId)) {
+            return;
+        }
+    }
+
+    if (paging->done && paging->emitted == paging->requested) {
+        QString path = paging->path;
+        QString cursor = paging->lastCursor;
+        m_pagings.remove(pagingId);
+        delete paging;
+        emit listFolderPagingFinished(path, cursor);
+    } else {
+        fetchNextPage(pagingId);
+    }
+}
+
+bool QDropbox::peekCursor(const QByteArray& data, QString& cursor, bool& hasMore) {
+    // a byte scan of the top-level object, same keys inside entries are skipped along with their nesting
+    bool cursorFound = false;
+    bool hasMoreFound = false;
+    int depth = 0;
+    QByteArray key;
+    const int size = data.size();
+    for (int i = 0; i < size && !(cursorFound && hasMoreFound); i++) {
+        char c = data.at(i);
+        if (c == '"') {
+            int end = i + 1;
+            while (end < size && data.at(end) != '"') {
+                end += data.at(end) == '\\' ? 2 : 1;
+            }
+            if (end >= size) {
+                return false;
+            }
+
+            if (depth == 1) {
+                QByteArray token = data.mid(i + 1, end - i - 1);
+                int next = end + 1;
+                while (next < size && (data.at(next) == ' ' || data.at(next) == '\n' || data.at(next) == '\r' || data.at(next) == '\t')) {
+                    next++;
+                }
+                if (next < size && data.at(next) == ':') {
+                    key = token;
+                    end = next;
+                } else if (key == "cursor") {
+                    if (token.contains('\\')) {
+                        return false;
+                    }
+                    cursor = QString::fromUtf8(token);
+                    cursorFound = true;
+                    key.clear();
+                }
+            }
+            i = end;
+        } else if (c == '{' || c == '[') {
+            depth++;
+        } else if (c == '}' || c == ']') {
+            depth--;
+        } else if (depth == 1 && key == "has_more" && (c == 't' || c == 'f')) {
+            hasMore = c == 't';
+            hasMoreFound = true;
+            key.clear();
+        }
+    }
+    return cursorFound && hasMoreFound;
+}
+
+QDropboxRequest* QDropbox::listFolderLongPoll(const QString& cursor, const int& timeout) {
     QNetworkRequest req = prepareNotifyRequest("/files/list_folder/longpoll");
 
     QVariantMap map;
@@ -219,13 +594,10 @@ void QDropbox::listFolderLongPoll(const QString& cursor, const int& timeout) {
 
     logger.debug(map);
 
-    QNetworkReply* reply = m_network.post(req, QJson::Serializer().serialize(map));
-    reply->setProperty("cursor", cursor);
-    bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onListFolderLongPoll()));
-    Q_ASSERT(res);
-    res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
-    Q_ASSERT(res);
-    Q_UNUSED(res);
+    QDropboxRequest* request = send(req, QJson::Serializer().serialize(map), SLOT(onListFolderLongPoll()));
+    request->setTimeout((timeout + LONGPOLL_JITTER) * 1000);
+    request->getContext().cursor = cursor;
+    return request;
 }
 
 void QDropbox::onListFolderLongPoll() {
@@ -236,25 +608,22 @@ void QDropbox::onListFolderLongPoll() {
         QVariant data = QJson::Parser().parse(reply->readAll(), &res);
         if (res) {
             QVariantMap dataMap = data.toMap();
-            emit listFolderLongPollFinished(reply->property("cursor").toString(), dataMap.value("changes").toBool());
+            emit listFolderLongPollFinished(context().cursor, dataMap.value("changes").toBool(), dataMap.value("backoff", 0).toInt());
         }
     }
 
     reply->deleteLater();
 }
 
-void QDropbox::createFolder(const QString& path, const bool& autorename) {
+QDropboxRequest* QDropbox::createFolder(const QString& path, const bool& autorename) {
     QNetworkRequest req = prepareRequest("/files/create_folder_v2");
     QVariantMap map;
     map["path"] = path;
     map["autorename"] = autorename;
 
-    QNetworkReply* reply = m_network.post(req, QJson::Serializer().serialize(map));
-    bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onFolderCreated()));
-    Q_ASSERT(res);
-    res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
-    Q_ASSERT(res);
-    Q_UNUSED(res);
+    QDropboxRequest* request = send(req, QJson::Serializer().serialize(map), SLOT(onFolderCreated()));
+    request->setIdempotent(false);
+    return request;
 }
 
 void QDropbox::onFolderCreated() {
@@ -274,17 +643,22 @@ void QDropbox::onFolderCreated() {
     reply->deleteLater();
 }
 
-void QDropbox::deleteFile(const QString& path) {
+QDropboxRequest* QDropbox::deleteFile(const QString& path) {
+    if (m_writeCombining) {
+        QDropboxRequest* request = combine(SLOT(onFileDeleted()));
+        request->getContext().path = path;
+        m_pendingDeletes.append(request);
+        scheduleWrites(m_pendingDeletes.size());
+        return request;
+    }
+
     QNetworkRequest req = prepareRequest("/files/delete_v2");
     QVariantMap map;
     map["path"] = path;
 
-    QNetworkReply* reply = m_network.post(req, QJson::Serializer().serialize(map));
-    bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onFileDeleted()));
-    Q_ASSERT(res);
-    res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
-    Q_ASSERT(res);
-    Q_UNUSED(res);
+    QDropboxRequest* request = send(req, QJson::Serializer().serialize(map), SLOT(onFileDeleted()));
+    request->setIdempotent(false);
+    return request;
 }
 
 void QDropbox::onFileDeleted() {
@@ -303,7 +677,7 @@ void QDropbox::onFileDeleted() {
     reply->deleteLater();
 }
 
-void QDropbox::deleteBatch(const QStringList& paths) {
+QDropboxRequest* QDropbox::deleteBatch(const QStringList& paths) {
     QNetworkRequest req = prepareRequest("/files/delete_batch");
     QVariantMap map;
     QVariantList entries;
@@ -317,13 +691,10 @@ void QDropbox::deleteBatch(const QStringList& paths) {
     QByteArray data = QJson::Serializer().serialize(map);
     logger.debug(data);
 
-    QNetworkReply* reply = m_network.post(req, data);
-    reply->setProperty("paths", paths);
-    bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onDeletedBatch()));
-    Q_ASSERT(res);
-    res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
-    Q_ASSERT(res);
-    Q_UNUSED(res);
+    QDropboxRequest* request = send(req, data, SLOT(onDeletedBatch()));
+    request->setIdempotent(false);
+    request->getContext().paths = paths;
+    return request;
 }
 
 void QDropbox::onDeletedBatch() {
@@ -334,22 +705,33 @@ void QDropbox::onDeletedBatch() {
         bool res = false;
         QVariant data = parser.parse(reply->readAll(), &res);
         if (res) {
-            emit deletedBatch(reply->property("paths").toStringList());
+            emit deletedBatch(context().paths);
+            QVariantMap map = data.toMap();
+            if (map.value(".tag").toString().compare("async_job_id") == 0) {
+                emit asyncJobLaunched(DELETE_BATCH_JOB, map.value("async_job_id").toString());
+            }
         }
     }
 
     reply->deleteLater();
 }
 
-void QDropbox::move(const QString& fromPath, const QString& toPath, const bool& allowSharedFolder, const bool& autorename, const bool& allowOwnershipTransfer) {
-    QNetworkReply* reply = moveFile(fromPath, toPath, allowSharedFolder, autorename, allowOwnershipTransfer);
-    reply->setProperty("from_path", fromPath);
-    reply->setProperty("to_path", toPath);
-    bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onMoved()));
-    Q_ASSERT(res);
-    res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
-    Q_ASSERT(res);
-    Q_UNUSED(res);
+QDropboxRequest* QDropbox::move(const QString& fromPath, const QString& toPath, const bool& allowSharedFolder, const bool& autorename, const bool& allowOwnershipTransfer) {
+    if (m_writeCombining) {
+        // entries of one move_batch share the flags, so moves are grouped by them
+        int flags = (allowSharedFolder ? 1 : 0) | (autorename ? 2 : 0) | (allowOwnershipTransfer ? 4 : 0);
+        QDropboxRequest* request = combine(SLOT(onMoved()));
+        request->getContext().fromPath = fromPath;
+        request->getContext().toPath = toPath;
+        m_pendingMoves[flags].append(request);
+        scheduleWrites(m_pendingMoves[flags].size());
+        return request;
+    }
+
+    QDropboxRequest* request = moveFile(fromPath, toPath, SLOT(onMoved()), allowSharedFolder, autorename, allowOwnershipTransfer);
+    request->getContext().fromPath = fromPath;
+    request->getContext().toPath = toPath;
+    return request;
 }
 
 void QDropbox::onMoved() {
@@ -361,14 +743,14 @@ void QDropbox::onMoved() {
         if (res) {
             QDropboxFile* pFile = new QDropboxFile(this);
             pFile->fromMap(data.toMap().value("metadata").toMap());
-            emit moved(pFile, reply->property("from_path").toString(), reply->property("to_path").toString());
+            emit moved(pFile, context().fromPath, context().toPath);
         }
     }
 
     reply->deleteLater();
 }
 
-void QDropbox::moveBatch(const QList<MoveEntry>& moveEntries, const bool& allowSharedFolder, const bool& autorename, const bool& allowOwnershipTransfer) {
+QDropboxRequest* QDropbox::moveBatch(const QList<MoveEntry>& moveEntries, const bool& allowSharedFolder, const bool& autorename, const bool& allowOwnershipTransfer) {
     QNetworkRequest req = prepareRequest("/files/move_batch");
     QVariantMap map;
     QVariantList entries;
@@ -383,13 +765,12 @@ void QDropbox::moveBatch(const QList<MoveEntry>& moveEntries, const bool& allowS
     QByteArray data = QJson::Serializer().serialize(map);
     logger.debug(data);
 
-    QNetworkReply* reply = m_network.post(req, data);
-    reply->setProperty("entries", entries);
-    bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onMovedBatch()));
-    Q_ASSERT(res);
-    res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
-    Q_ASSERT(res);
-    Q_UNUSED(res);
+    QDropboxRequest* request = send(req, data, SLOT(onMovedBatch()));
+    request->setIdempotent(false);
+    foreach(MoveEntry e, moveEntries) {
+        request->getContext().moves.append(qMakePair(e.fromPath, e.toPath));
+    }
+    return request;
 }
 
 void QDropbox::onMovedBatch() {
@@ -397,25 +778,270 @@ void QDropbox::onMovedBatch() {
 
     if (reply->error() == QNetworkReply::NoError) {
         QList<MoveEntry> moveEntries;
-        QVariantList entries = reply->property("entries").toList();
-        foreach(QVariant v, entries) {
-            MoveEntry e;
-            e.fromMap(v.toMap());
-            moveEntries.append(e);
+        typedef QPair<QString, QString> Move;
+        foreach(Move move, context().moves) {
+            moveEntries.append(MoveEntry(move.first, move.second));
         }
         emit movedBatch(moveEntries);
+
+        bool res = false;
+        QVariantMap map = QJson::Parser().parse(reply->readAll(), &res).toMap();
+        if (res && map.value(".tag").toString().compare("async_job_id") == 0) {
+            emit asyncJobLaunched(MOVE_BATCH_JOB, map.value("async_job_id").toString());
+        }
     }
 
     reply->deleteLater();
 }
 
-void QDropbox::rename(const QString& fromPath, const QString& toPath, const bool& allowSharedFolder, const bool& autorename, const bool& allowOwnershipTransfer) {
-    QNetworkReply* reply = moveFile(fromPath, toPath, allowSharedFolder, autorename, allowOwnershipTransfer);
-    bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onRenamed()));
-    Q_ASSERT(res);
-    res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
+QDropboxRequest* QDropbox::copy(const QString& fromPath, const QString& toPath, const bool& allowSharedFolder, const bool& autorename, const bool& allowOwnershipTransfer) {
+    QNetworkRequest req = prepareRequest("/files/copy_v2");
+    QVariantMap map;
+    map["from_path"] = fromPath;
+    map["to_path"] = toPath;
+    map["allow_shared_folder"] = allowSharedFolder;
+    map["autorename"] = autorename;
+    map["allow_ownership_transfer"] = allowOwnershipTransfer;
+
+    QByteArray data = QJson::Serializer().serialize(map);
+    logger.debug(data);
+
+    QDropboxRequest* request = send(req, data, SLOT(onCopied()));
+    request->setIdempotent(false);
+    request->getContext().fromPath = fromPath;
+    request->getContext().toPath = toPath;
+    return request;
+}
+
+void QDropbox::onCopied() {
+    QNetworkReply* reply = getReply();
+
+    if (reply->error() == QNetworkReply::NoError) {
+        bool res = false;
+        QVariant data = QJson::Parser().parse(reply->readAll(), &res);
+        if (res) {
+            QDropboxFile* pFile = new QDropboxFile(this);
+            pFile->fromMap(data.toMap().value("metadata").toMap());
+            emit copied(pFile, context().fromPath, context().toPath);
+        }
+    }
+
+    reply->deleteLater();
+}
+
+QDropboxRequest* QDropbox::copyBatch(const QList<MoveEntry>& copyEntries, const bool& autorename) {
+    QNetworkRequest req = prepareRequest("/files/copy_batch_v2");
+    QVariantMap map;
+    QVariantList entries;
+    foreach(MoveEntry e, copyEntries) {
+        entries.append(e.toMap());
+    }
+    map["entries"] = entries;
+    map["autorename"] = autorename;
+
+    QByteArray data = QJson::Serializer().serialize(map);
+    logger.debug(data);
+
+    QDropboxRequest* request = send(req, data, SLOT(onCopiedBatch()));
+    request->setIdempotent(false);
+    request->getContext().entries = entries;
+    return request;
+}
+
+void QDropbox::onCopiedBatch() {
+    QNetworkReply* reply = getReply();
+
+    if (reply->error() == QNetworkReply::NoError) {
+        QList<MoveEntry> copyEntries;
+        foreach(QVariant entry, context().entries) {
+            copyEntries.append(MoveEntry(entry.toMap().value("from_path").toString(), entry.toMap().value("to_path").toString()));
+        }
+        emit copiedBatch(copyEntries);
+
+        // results of each copy come either right away or with the finished job, as with combined writes
+        bool res = false;
+        QVariantMap map = QJson::Parser().parse(reply->readAll(), &res).toMap();
+        if (res && map.value(".tag").toString().compare("async_job_id") == 0) {
+            CombinedWrite job;
+            job.kind = COPY_BATCH_V2_JOB;
+            job.entries = context().entries;
+            m_combinedJobs.insert(map.value("async_job_id").toString(), job);
+            emit asyncJobLaunched(COPY_BATCH_V2_JOB, map.value("async_job_id").toString());
+        } else if (res) {
+            completeCombinedWrite(COPY_BATCH_V2_JOB, map, context().entries, QList<QDropboxRequest*>());
+        }
+    }
+
+    reply->deleteLater();
+}
+
+void QDropbox::flushWrites() {
+    m_writeCombineTimer.stop();
+
+    while (m_pendingDeletes.size()) {
+        QList<QDropboxRequest*> batched = m_pendingDeletes.mid(0, WRITE_BATCH_SIZE);
+        m_pendingDeletes = m_pendingDeletes.mid(batched.size());
+
+        QVariantList entries;
+        foreach(QDropboxRequest* request, batched) {
+            QVariantMap entry;
+            entry["path"] = request->getContext().path;
+            entries.append(entry);
+        }
+        QVariantMap map;
+        map["entries"] = entries;
+        postCombinedWrite(DELETE_BATCH_JOB, "/files/delete_batch", map, entries, batched);
+    }
+
+    foreach(int flags, m_pendingMoves.keys()) {
+        QList<QDropboxRequest*> pending = m_pendingMoves.take(flags);
+        while (pending.size()) {
+            QList<QDropboxRequest*> batched = pending.mid(0, WRITE_BATCH_SIZE);
+            pending = pending.mid(batched.size());
+
+            QVariantList entries;
+            foreach(QDropboxRequest* request, batched) {
+                QVariantMap entry;
+                entry["from_path"] = request->getContext().fromPath;
+                entry["to_path"] = request->getContext().toPath;
+                entries.append(entry);
+            }
+            QVariantMap map;
+            map["entries"] = entries;
+            map["allow_shared_folder"] = (flags & 1) != 0;
+            map["autorename"] = (flags & 2) != 0;
+            map["allow_ownership_transfer"] = (flags & 4) != 0;
+            postCombinedWrite(MOVE_BATCH_V2_JOB, "/files/move_batch_v2", map, entries, batched);
+        }
+    }
+}
+
+void QDropbox::onCombinedWriteLaunched() {
+    QNetworkReply* reply = getReply();
+    const QDropboxRequestContext& ctx = context();
+
+    if (reply->error() == QNetworkReply::NoError) {
+        bool res = false;
+        QVariant data = QJson::Parser().parse(reply->readAll(), &res);
+        if (res) {
+            QVariantMap dataMap = data.toMap();
+            if (dataMap.value(".tag").toString().compare("async_job_id") == 0) {
+                CombinedWrite job;
+                job.kind = ctx.type;
+                job.entries = ctx.entries;
+                job.batched = ctx.batched;
+                m_combinedJobs.insert(dataMap.value("async_job_id").toString(), job);
+                emit asyncJobLaunched(ctx.type, dataMap.value("async_job_id").toString());
+            } else {
+                completeCombinedWrite(ctx.type, dataMap, ctx.entries, ctx.batched);
+            }
+        } else {
+            failCombinedWrite(ctx.batched, QNetworkReply::UnknownContentError, "Cannot parse batch result");
+        }
+    } else {
+        const QDropboxResult& result = m_pCurrentRequest->getResult();
+        failCombinedWrite(ctx.batched, result.isOk() ? reply->error() : result.error, result.isOk() ? reply->errorString() : result.errorString);
+    }
+
+    reply->deleteLater();
+}
+
+void QDropbox::onAsyncJobFinished(const AsyncJobStatus& status) {
+    m_jobTokens.remove(status.asyncJobId);
+    if (!m_combinedJobs.contains(status.asyncJobId)) {
+        return;
+    }
+
+    CombinedWrite job = m_combinedJobs.take(status.asyncJobId);
+    if (status.status == AsyncJobStatus::Complete) {
+        completeCombinedWrite(job.kind, status.result, job.entries, job.batched);
+    } else {
+        failCombinedWrite(job.batched, QNetworkReply::UnknownContentError, "Batch job failed: " + QString(QJson::Serializer().serialize(status.result)));
+    }
+}
+
+void QDropbox::scheduleWrites(const int& pending) {
+    if (pending >= WRITE_BATCH_SIZE) {
+        flushWrites();
+    } else if (!m_writeCombineTimer.isActive()) {
+        m_writeCombineTimer.start();
+    }
+}
+
+QDropboxRequest* QDropbox::combine(const char* slot) {
+    // handle of a single write, settled by its entry of the combined batch
+    QDropboxRequest* request = new QDropboxRequest(QNetworkRequest(), QByteArray(), slot, this);
+    request->setNamespace(token());
+    bool res = QObject::connect(request, SIGNAL(cancelled()), this, SLOT(onRequestCancelled()));
     Q_ASSERT(res);
     Q_UNUSED(res);
+    return request;
+}
+
+void QDropbox::postCombinedWrite(const QString& kind, const QString& apiMethod, const QVariantMap& map, const QVariantList& entries, const QList<QDropboxRequest*>& batched) {
+    QNetworkRequest req = prepareRequest(apiMethod);
+    QDropboxRequest* request = send(req, QJson::Serializer().serialize(map), SLOT(onCombinedWriteLaunched()));
+    request->setIdempotent(false);
+    request->getContext().type = kind;
+    request->getContext().entries = entries;
+    request->getContext().batched = batched;
+}
+
+void QDropbox::failCombinedWrite(const QList<QDropboxRequest*>& batched, const QNetworkReply::NetworkError& error, const QString& errorString) {
+    foreach(QDropboxRequest* request, batched) {
+        request->reject(error, errorString);
+        settleCombined(request);
+    }
+}
+
+void QDropbox::settleCombined(QDropboxRequest* request) {
+    // the entry went out with the batch anyway, a cancelled call only reports so
+    if (request->isCancelled()) {
+        request->reject(QNetworkReply::OperationCanceledError, "Request cancelled");
+    }
+    request->finish();
+    request->deleteLater();
+}
+
+void QDropbox::completeCombinedWrite(const QString& kind, const QVariantMap& data, const QVariantList& entries, const QList<QDropboxRequest*>& batched) {
+    QVariantList results = data.value("entries").toList();
+    bool deleting = kind.compare(DELETE_BATCH_JOB) == 0;
+    for (int i = 0; i < entries.size(); i++) {
+        QVariantMap result = results.value(i).toMap();
+        QVariantMap entry = entries.at(i).toMap();
+        QDropboxRequest* request = batched.value(i, 0);
+        if (result.value(".tag").toString().compare("success") != 0) {
+            QString errorString = "Batch entry failed: " + QString(QJson::Serializer().serialize(result));
+            logger.error(errorString);
+            if (request != 0) {
+                request->reject(QNetworkReply::UnknownContentError, errorString);
+                settleCombined(request);
+            }
+            continue;
+        }
+
+        QVariantMap metadata = result.contains("metadata") ? result.value("metadata").toMap() : result.value("success").toMap();
+        if (request != 0) {
+            QVariantMap value;
+            value["metadata"] = metadata;
+            request->resolve(value);
+            settleCombined(request);
+        }
+
+        QDropboxFile* pFile = new QDropboxFile(this);
+        pFile->fromMap(metadata);
+        if (deleting) {
+            emit fileDeleted(pFile);
+        } else if (kind.compare(COPY_BATCH_V2_JOB) == 0) {
+            emit copied(pFile, entry.value("from_path").toString(), entry.value("to_path").toString());
+        } else {
+            emit moved(pFile, entry.value("from_path").toString(), entry.value("to_path").toString());
+        }
+    }
+}
+
+QDropboxRequest* QDropbox::rename(const QString& fromPath, const QString& toPath, const bool& allowSharedFolder, const bool& autorename, const bool& allowOwnershipTransfer) {
+    return moveFile(fromPath, toPath, SLOT(onRenamed()), allowSharedFolder, autorename, allowOwnershipTransfer);
 }
 
 void QDropbox::onRenamed() {
@@ -434,77 +1060,290 @@ void QDropbox::onRenamed() {
     reply->deleteLater();
 }
 
-void QDropbox::getThumbnail(const QString& path, const QString& size, const QString& format) {
+QDropboxRequest* QDropbox::getThumbnail(const QString& path, const QString& size, const QString& format) {
     if (!path.trimmed().isEmpty()) {
-        QNetworkRequest req = prepareContentRequest("/files/get_thumbnail", false);
+        QDropboxRequest* found = findThumbnail(path, size, format);
+        if (found != 0) {
+            return found;
+        }
 
-        QVariantMap map;
+        if (m_thumbnailBatching) {
+            return enqueueThumbnail(path, size, format);
+        }
+
+        // the caller gets the decoded image, not the call, which may be shared with other callers
+        QDropboxRequest* thumbnail = awaitThumbnail(thumbnailKey(path, size, format));
+        if (m_coalesceRequests && m_inflight.contains(thumbnail->getContext().coalesceKey)) {
+            return thumbnail;
+        }
 
-        QVariantMap sizeMap;
-        sizeMap[".tag"] = size;
-        map["size"] = sizeMap;
-        map["path"] = path;
-        map["format"] = format;
+        QNetworkRequest req = prepareContentRequest("/files/get_thumbnail", false);
 
-        QJson::Serializer serializer;
-        QByteArray data = serializer.serialize(map);
+        QByteArray data = thumbnailArg(path, size, format);
         req.setRawHeader("Dropbox-API-Arg", data);
 
 //        logger.debug("Dropbox-API-Arg: " + data);
 
-        QNetworkReply* reply = m_network.post(req, "");
-        reply->setProperty("path", path);
-        reply->setProperty("size", size);
-        bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onThumbnailLoaded()));
-        Q_ASSERT(res);
-        res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
-        Q_ASSERT(res);
-        Q_UNUSED(res);
+        QDropboxRequest* request = send(req, "", SLOT(onThumbnailLoaded()));
+        request->getContext().path = path;
+        request->getContext().size = size;
+        request->getContext().format = format;
+        registerInflight(QString("/files/get_thumbnail").append(data), request);
+        return thumbnail;
     }
 
+    return rejected(QNetworkReply::ProtocolInvalidOperationError, "Thumbnail path is empty");
 }
 
 void QDropbox::onThumbnailLoaded() {
     QNetworkReply* reply = getReply();
+    unregisterInflight(reply);
 
     if (reply->error() == QNetworkReply::NoError) {
-        QImage* thumbnail = new QImage();
-        thumbnail->loadFromData(reply->readAll());
-        emit thumbnailLoaded(reply->property("path").toString(), reply->property("size").toString(), thumbnail);
+        QVariantMap entry;
+        entry["path"] = context().path;
+        entry["size"] = context().size;
+        entry["format"] = context().format;
+        entry["key"] = context().coalesceKey;
+        decodeThumbnails(reply->readAll(), QVariantList() << entry, QDropboxThumbnailDecoder::Single);
+    } else {
+        emit thumbnailFailed(context().path, context().size, reply->error(), reply->errorString());
+        settleThumbnail(context().coalesceKey, QImage(), reply->error(), reply->errorString());
     }
 
     reply->deleteLater();
 }
 
-void QDropbox::download(const QString& path, const QString& rev) {
-    QNetworkRequest req = prepareContentRequest("/files/download");
+QList<QDropboxRequest*> QDropbox::getThumbnailBatch(const QStringList& paths, const QString& size, const QString& format) {
+    QList<QDropboxRequest*> requests;
+    foreach(QString path, paths) {
+        if (path.trimmed().isEmpty()) {
+            requests.append(rejected(QNetworkReply::ProtocolInvalidOperationError, "Thumbnail path is empty"));
+            continue;
+        }
+        QDropboxRequest* found = findThumbnail(path, size, format);
+        requests.append(found != 0 ? found : enqueueThumbnail(path, size, format));
+    }
+    flushThumbnailBatch();
+    return requests;
+}
 
+QByteArray QDropbox::thumbnailArg(const QString& path, const QString& size, const QString& format) const {
     QVariantMap map;
+
+    QVariantMap sizeMap;
+    sizeMap[".tag"] = size;
+    map["size"] = sizeMap;
     map["path"] = path;
-    if (!rev.isEmpty()) {
-        map["rev"] = rev;
+    map["format"] = format;
+
+    return QJson::Serializer().serialize(map);
+}
+
+QString QDropbox::thumbnailKey(const QString& path, const QString& size, const QString& format) const {
+    return token().append("|/files/get_thumbnail").append(thumbnailArg(path, size, format));
+}
+
+QDropboxRequest* QDropbox::enqueueThumbnail(const QString& path, const QString& size, const QString& format) {
+    // on the wire already, single or batched, its result settles this caller too
+    QString key = thumbnailKey(path, size, format);
+    QDropboxRequest* request = awaitThumbnail(key);
+    if (m_coalesceRequests && m_inflight.contains(key)) {
+        return request;
     }
 
-    req.setRawHeader("Dropbox-API-Arg", QJson::Serializer().serialize(map));
+    for (int i = 0; i < m_pendingThumbnails.size(); i++) {
+        QVariantMap& pending = m_pendingThumbnails[i];
+        if (pending.value("key").toString().compare(key) == 0) {
+            return request;
+        }
+    }
 
-    QNetworkReply* reply = m_network.post(req, "");
-    reply->setReadBufferSize(m_readBufferSize);
-    reply->setProperty("path", path);
-    m_downloadsQueue.append(reply);
+    QVariantMap pending;
+    pending["path"] = path;
+    pending["size"] = size;
+    pending["format"] = format;
+    pending["key"] = key;
+    pending["token"] = token();
+    m_pendingThumbnails.append(pending);
+
+    if (m_pendingThumbnails.size() >= THUMBNAIL_BATCH_SIZE) {
+        flushThumbnailBatch();
+    } else if (!m_thumbnailBatchTimer.isActive()) {
+        m_thumbnailBatchTimer.start();
+    }
+    return request;
+}
+
+void QDropbox::flushThumbnailBatch() {
+    m_thumbnailBatchTimer.stop();
+
+    QString scopedToken = m_scopedToken;
+    while (m_pendingThumbnails.size()) {
+        // a batch carries the thumbnails of one account only
+        m_scopedToken = m_pendingThumbnails.first().value("token").toString();
+        QVariantList entries;
+        QVariantList requested;
+        while (m_pendingThumbnails.size() && entries.size() < THUMBNAIL_BATCH_SIZE &&
+                m_pendingThumbnails.first().value("token").toString().compare(m_scopedToken) == 0) {
+            QVariantMap pending = m_pendingThumbnails.takeFirst();
+            QVariantMap sizeMap;
+            sizeMap[".tag"] = pending.value("size");
+            QVariantMap entry;
+            entry["path"] = pending.value("path");
+            entry["size"] = sizeMap;
+            entry["format"] = pending.value("format");
+            entries.append(entry);
+            requested.append(pending);
+        }
 
-    bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onDownloaded()));
-    Q_ASSERT(res);
-    res = QObject::connect(reply, SIGNAL(downloadProgress(qint64,qint64)), this, SLOT(onDownloadProgress(qint64,qint64)));
-    Q_ASSERT(res);
-    res = QObject::connect(reply, SIGNAL(readyRead()), this, SLOT(read()));
+        QNetworkRequest req = prepareContentRequest("/files/get_thumbnail_batch", false);
+        req.setRawHeader("Content-Type", "application/json");
+        QVariantMap map;
+        map["entries"] = entries;
+
+        QDropboxRequest* request = send(req, QJson::Serializer().serialize(map), SLOT(onThumbnailBatchLoaded()));
+        request->getContext().entries = requested;
+        if (m_coalesceRequests) {
+            foreach(QVariant pending, requested) {
+                m_inflight.insert(pending.toMap().value("key").toString(), request);
+            }
+        }
+    }
+    m_scopedToken = scopedToken;
+}
+
+void QDropbox::onThumbnailBatchLoaded() {
+    QNetworkReply* reply = getReply();
+    foreach(QVariant pending, context().entries) {
+        QString key = pending.toMap().value("key").toString();
+        if (m_inflight.value(key, 0) == m_pCurrentRequest) {
+            m_inflight.remove(key);
+        }
+    }
+
+    if (reply->error() != QNetworkReply::NoError) {
+        foreach(QVariant pending, context().entries) {
+            QVariantMap entry = pending.toMap();
+            emit thumbnailFailed(entry.value("path").toString(), entry.value("size").toString(), reply->error(), reply->errorString());
+            settleThumbnail(entry.value("key").toString(), QImage(), reply->error(), reply->errorString());
+        }
+    } else {
+        decodeThumbnails(reply->readAll(), context().entries, QDropboxThumbnailDecoder::Batch);
+    }
+
+    reply->deleteLater();
+}
+
+void QDropbox::onThumbnailsDecoded() {
+    QDropboxThumbnailDecoder* decoder = qobject_cast<QDropboxThumbnailDecoder*>(QObject::sender());
+    foreach(DecodedThumbnail thumbnail, decoder->getThumbnails()) {
+        if (thumbnail.errorString.isEmpty()) {
+            emitThumbnail(thumbnail.path, thumbnail.size, thumbnail.format, thumbnail.data, thumbnail.image);
+            settleThumbnail(thumbnail.key, thumbnail.image);
+        } else {
+            if (m_pThumbnailCache != 0) {
+                m_pThumbnailCache->remove(thumbnail.path, thumbnail.size, thumbnail.format);
+            }
+            emit thumbnailFailed(thumbnail.path, thumbnail.size, QNetworkReply::UnknownContentError, thumbnail.errorString);
+            settleThumbnail(thumbnail.key, QImage(), QNetworkReply::UnknownContentError, thumbnail.errorString);
+        }
+    }
+    decoder->deleteLater();
+}
+
+QDropboxRequest* QDropbox::findThumbnail(const QString& path, const QString& size, const QString& format) {
+    if (m_pThumbnailCache == 0) {
+        return 0;
+    }
+
+    QImage* thumbnail = m_pThumbnailCache->find(path, size, format);
+    if (thumbnail != 0) {
+        QDropboxRequest* request = resolved(QVariant::fromValue(*thumbnail));
+        emit thumbnailLoaded(path, size, thumbnail);
+        return request;
+    }
+
+    // a disk hit is decoded like a download, off the main thread and at the scaled size
+    QByteArray data = m_pThumbnailCache->findData(path, size, format);
+    if (data.isEmpty()) {
+        return 0;
+    }
+    QVariantMap entry;
+    entry["path"] = path;
+    entry["size"] = size;
+    entry["format"] = format;
+    entry["key"] = thumbnailKey(path, size, format);
+    decodeThumbnails(data, QVariantList() << entry, QDropboxThumbnailDecoder::Single);
+    return awaitThumbnail(entry.value("key").toString());
+}
+
+QDropboxRequest* QDropbox::awaitThumbnail(const QString& key) {
+    // settled with the image once the thumbnail of this key is decoded or has failed
+    QDropboxRequest* request = new QDropboxRequest(QNetworkRequest(), QByteArray(), 0, this);
+    request->setNamespace(token());
+    request->getContext().coalesceKey = key;
+    m_thumbnailRequests.insert(key, request);
+
+    bool res = QObject::connect(request, SIGNAL(cancelled()), this, SLOT(onRequestCancelled()));
     Q_ASSERT(res);
-    res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
+    Q_UNUSED(res);
+    return request;
+}
+
+void QDropbox::settleThumbnail(const QString& key, const QImage& image, const QNetworkReply::NetworkError& error, const QString& errorString) {
+    QList<QDropboxRequest*> requests = m_thumbnailRequests.values(key);
+    m_thumbnailRequests.remove(key);
+    foreach(QDropboxRequest* request, requests) {
+        if (error == QNetworkReply::NoError) {
+            request->resolve(QVariant::fromValue(image));
+        } else {
+            request->reject(error, errorString);
+        }
+        request->finish();
+        request->deleteLater();
+    }
+}
+
+void QDropbox::decodeThumbnails(const QByteArray& data, const QVariantList& entries, const QDropboxThumbnailDecoder::Mode& mode) {
+    QDropboxThumbnailDecoder* decoder = new QDropboxThumbnailDecoder(data, entries, mode);
+    decoder->setScaledSize(m_thumbnailScaledSize);
+    bool res = QObject::connect(decoder, SIGNAL(decoded()), this, SLOT(onThumbnailsDecoded()));
     Q_ASSERT(res);
     Q_UNUSED(res);
+    QThreadPool::globalInstance()->start(decoder);
+}
+
+void QDropbox::releaseThumbnail(QImage* thumbnail) {
+    QDropboxThumbnailDecoder::recycle(thumbnail);
+}
+
+void QDropbox::emitThumbnail(const QString& path, const QString& size, const QString& format, const QByteArray& data, const QImage& image) {
+    if (m_pThumbnailCache != 0) {
+        // the cache keeps pixels of its own, so the image handed out can go back to the pool once released
+        m_pThumbnailCache->insert(path, size, format, data, image.copy());
+    }
+    emit thumbnailLoaded(path, size, new QImage(image));
+}
+
+QDropboxRequest* QDropbox::download(const QString& path, const QString& rev) {
+    QNetworkRequest req = prepareContentRequest("/files/download");
+
+    QVariantMap map;
+    map["path"] = path;
+    if (!rev.isEmpty()) {
+        map["rev"] = rev;
+    }
+
+    req.setRawHeader("Dropbox-API-Arg", QJson::Serializer().serialize(map));
+
     emit downloadStarted(path);
+    QDropboxRequest* request = transfer(req, 0, SLOT(read()), SLOT(onDownloaded()), &m_downloadsQueue);
+    request->getContext().path = path;
+    return request;
 }
 
-void QDropbox::downloadZip(const QString& path, const QString& rev) {
+QDropboxRequest* QDropbox::downloadZip(const QString& path, const QString& rev) {
     QNetworkRequest req = prepareContentRequest("/files/download_zip");
 
     QVariantMap map;
@@ -515,26 +1354,225 @@ void QDropbox::downloadZip(const QString& path, const QString& rev) {
 
     req.setRawHeader("Dropbox-API-Arg", QJson::Serializer().serialize(map));
 
-    QNetworkReply* reply = m_network.post(req, "");
-    reply->setReadBufferSize(m_readBufferSize);
-    reply->setProperty("path", path);
-    m_downloadsQueue.append(reply);
+    emit downloadStarted(path);
+    QDropboxRequest* request = transfer(req, 0, SLOT(readZip()), SLOT(onDownloadedZip()), &m_downloadsQueue);
+    request->getContext().path = path;
+    return request;
+}
 
-    bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onDownloadedZip()));
-    Q_ASSERT(res);
-    res = QObject::connect(reply, SIGNAL(downloadProgress(qint64,qint64)), this, SLOT(onDownloadProgress(qint64,qint64)));
-    Q_ASSERT(res);
-    res = QObject::connect(reply, SIGNAL(readyRead()), this, SLOT(readZip()));
-    Q_ASSERT(res);
-    res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
+QDropboxRequest* QDropbox::downloadZip(const QString& path, QIODevice* device) {
+    return stream("/files/download_zip", path, "", device);
+}
+
+QDropboxRequest* QDropbox::download(const QString& path, QIODevice* sink, const QString& rev) {
+    return stream("/files/download", path, rev, sink);
+}
+
+QDropboxRequest* QDropbox::stream(const QString& apiMethod, const QString& path, const QString& rev, QIODevice* sink) {
+    QNetworkRequest req = prepareContentRequest(apiMethod);
+
+    QVariantMap map;
+    map["path"] = path;
+    if (!rev.isEmpty()) {
+        map["rev"] = rev;
+    }
+
+    req.setRawHeader("Dropbox-API-Arg", QJson::Serializer().serialize(map));
+
+    bool res = QObject::connect(sink, SIGNAL(bytesWritten(qint64)), this, SLOT(onSinkWritten(qint64)));
     Q_ASSERT(res);
     Q_UNUSED(res);
     emit downloadStarted(path);
+    QDropboxRequest* request = transfer(req, 0, SLOT(readStream()), SLOT(onDownloadStreamed()));
+    request->getContext().path = path;
+    request->getContext().device = sink;
+    // the sink reports back on its own, it leads to the download writing into it
+    m_sinks.insert(sink, request);
+    return request;
+}
+
+QDropboxRequest* QDropbox::downloadFile(const QString& path, const QString& localPath, const QString& rev, const QString& contentHash) {
+    if (m_pBlockStore != 0 && m_pBlockStore->materialize(contentHash, localPath)) {
+        // same content is already on disk, the copy runs on the thread pool and onMaterialized() completes the call
+        QVariantMap value;
+        value["path_display"] = path;
+        value["content_hash"] = contentHash;
+        QDropboxRequest* request = new QDropboxRequest(QNetworkRequest(), QByteArray(), 0, this);
+        request->getContext().path = path;
+        request->getContext().localPath = localPath;
+        request->getContext().rev = rev;
+        request->resolve(value);
+        m_localDownloads.insert(localPath, request);
+        return request;
+    }
+
+    QFileInfo info(localPath);
+    if (!info.absoluteDir().exists()) {
+        info.absoluteDir().mkpath(info.absolutePath());
+    }
+
+    // written next to the target and renamed once complete, so an interrupted download never looks finished
+    QFile* file = new QFile(localPath + ".part");
+    if (!file->open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        QString error = "Cannot open file: " + file->fileName();
+        logger.error(error);
+        delete file;
+        return rejected(QNetworkReply::UnknownContentError, error);
+    }
+
+    QNetworkRequest req = prepareContentRequest("/files/download");
+
+    QVariantMap map;
+    map["path"] = path;
+    if (!rev.isEmpty()) {
+        map["rev"] = rev;
+    }
+
+    req.setRawHeader("Dropbox-API-Arg", QJson::Serializer().serialize(map));
+
+    emit downloadStarted(path);
+    QDropboxRequest* request = transfer(req, 0, SLOT(readFile()), SLOT(onFileDownloaded()));
+    file->setParent(request);
+    request->getContext().path = path;
+    request->getContext().localPath = localPath;
+    request->getContext().device = file;
+    return request;
+}
+
+void QDropbox::readFile() {
+    QNetworkReply* reply = getReply();
+    QIODevice* device = context().device;
+    if (device != 0) {
+        device->write(reply->readAll());
+    }
+}
+
+void QDropbox::onFileDownloaded() {
+    QNetworkReply* reply = getReply();
+    const QDropboxRequestContext& ctx = context();
+    QFile* file = qobject_cast<QFile*>(ctx.device);
+
+    if (file != 0) {
+        file->write(reply->readAll());
+        file->close();
+        if (reply->error() == QNetworkReply::NoError) {
+            QFile::remove(ctx.localPath);
+            file->rename(ctx.localPath);
+            logger.debug("File downloaded: " + ctx.localPath);
+            if (m_pBlockStore != 0) {
+                QVariantMap metadata = QJson::Parser().parse(reply->rawHeader("Dropbox-API-Result")).toMap();
+                m_pBlockStore->insert(metadata.value("content_hash").toString(), ctx.localPath);
+            }
+            emit downloaded(ctx.path, ctx.localPath);
+        } else {
+            file->remove();
+        }
+    }
+
+    reply->deleteLater();
+}
+
+void QDropbox::onMaterialized(const QString& localPath, const bool& ok) {
+    QMultiHash<QString, QDropboxRequest*>::iterator it = m_localDownloads.find(localPath);
+    if (it == m_localDownloads.end()) {
+        return;
+    }
+    QDropboxRequest* request = it.value();
+    m_localDownloads.erase(it);
+
+    const QDropboxRequestContext& ctx = request->getContext();
+    if (request->isCancelled()) {
+        request->reject(QNetworkReply::OperationCanceledError, "Request cancelled");
+    } else if (!ok) {
+        // the local copy could not be made, the content is downloaded after all
+        QDropboxRequest* download = downloadFile(ctx.path, localPath, ctx.rev, "");
+        bool res = QObject::connect(download, SIGNAL(finished()), request, SLOT(onSourceFinished()));
+        Q_ASSERT(res);
+        Q_UNUSED(res);
+        return;
+    } else {
+        logger.debug("File materialized: " + localPath);
+        emit downloaded(ctx.path, localPath);
+    }
+    request->finish();
+    request->deleteLater();
+}
+
+void QDropbox::readStream() {
+    QNetworkReply* reply = getReply();
+    QIODevice* sink = context().device;
+    if (sink != 0) {
+        drain(reply, sink);
+    }
+}
+
+void QDropbox::onSinkWritten(qint64 bytes) {
+    QIODevice* sink = qobject_cast<QIODevice*>(QObject::sender());
+    QDropboxRequest* request = m_sinks.value(sink, 0);
+    if (request == 0 || request->getReply() == 0) {
+        return;
+    }
+
+    // a sink draining slowly is no stalled transfer
+    request->touch();
+    drain(request->getReply(), sink);
+    Q_UNUSED(bytes);
+}
+
+void QDropbox::drain(QNetworkReply* reply, QIODevice* sink) {
+    // data stays in the reply while the sink is backed up, once the read buffer is full the server is throttled
+    while (reply->bytesAvailable() > 0 && sink->bytesToWrite() < SINK_BUFFER_SIZE) {
+        QByteArray chunk = reply->peek(SINK_CHUNK_SIZE);
+        qint64 written = sink->write(chunk);
+        if (written < 0) {
+            logger.error("Cannot write download: " + sink->errorString());
+            reply->abort();
+            return;
+        }
+
+        // only what the sink took leaves the reply, the rest is written once it reports bytesWritten
+        reply->read(written);
+        if (written < chunk.size()) {
+            return;
+        }
+    }
+}
+
+void QDropbox::onDownloadStreamed() {
+    QNetworkReply* reply = getReply();
+    const QDropboxRequestContext& ctx = context();
+
+    if (ctx.device != 0) {
+        if (m_sinks.value(ctx.device, 0) == m_pCurrentRequest) {
+            m_sinks.remove(ctx.device);
+            QObject::disconnect(ctx.device, SIGNAL(bytesWritten(qint64)), this, SLOT(onSinkWritten(qint64)));
+        }
+        if (reply->error() == QNetworkReply::NoError) {
+            // no more than the read buffer is left at this point
+            QByteArray rest = reply->readAll();
+            qint64 written = 0;
+            while (written < rest.size()) {
+                qint64 count = ctx.device->write(rest.constData() + written, rest.size() - written);
+                if (count <= 0) {
+                    break;
+                }
+                written += count;
+            }
+            if (written < rest.size()) {
+                logger.error("Cannot write download: " + ctx.device->errorString());
+                m_pCurrentRequest->reject(QNetworkReply::UnknownContentError, "Sink did not accept the end of " + ctx.path);
+            } else {
+                emit downloadStreamed(ctx.path, ctx.device);
+            }
+        }
+    }
+
+    reply->deleteLater();
 }
 
 void QDropbox::read() {
     QNetworkReply* reply = getReply();
-    QString path = reply->property("path").toString();
+    QString path = context().path;
     QDir dir(m_downloadsFolder);
     if (!dir.exists()) {
         dir.mkpath(m_downloadsFolder);
@@ -549,7 +1587,7 @@ void QDropbox::read() {
 
 void QDropbox::readZip() {
     QNetworkReply* reply = getReply();
-    QString path = reply->property("path").toString();
+    QString path = context().path;
     QDir dir(m_downloadsFolder);
     if (!dir.exists()) {
         dir.mkpath(m_downloadsFolder);
@@ -563,15 +1601,14 @@ void QDropbox::readZip() {
 }
 
 void QDropbox::onDownloadProgress(qint64 loaded, qint64 total) {
-    QNetworkReply* reply = getReply();
-    emit downloadProgress(reply->property("path").toString(), loaded, total);
+    emit downloadProgress(context().path, loaded, total);
 }
 
 void QDropbox::onDownloaded() {
     QNetworkReply* reply = getReply();
 
     if (reply->error() == QNetworkReply::NoError) {
-        QString path = reply->property("path").toString();
+        QString path = context().path;
         QString filename = getFilename(path);
         QString localPath = m_downloadsFolder + "/" + filename;
         logger.debug("File downloaded: " + localPath);
@@ -586,7 +1623,7 @@ void QDropbox::onDownloadedZip() {
     QNetworkReply* reply = getReply();
 
     if (reply->error() == QNetworkReply::NoError) {
-        QString path = reply->property("path").toString();
+        QString path = context().path;
         QString filename = getFilename(path);
         QString localPath = m_downloadsFolder + "/" + filename + ".zip";
         logger.debug("File downloaded: " + localPath);
@@ -597,7 +1634,7 @@ void QDropbox::onDownloadedZip() {
     reply->deleteLater();
 }
 
-void QDropbox::upload(QFile* file, const QString& remotePath, const QString& mode, const bool& autorename, const bool& mute) {
+QDropboxRequest* QDropbox::upload(QFile* file, const QString& remotePath, const QString& mode, const bool& autorename, const bool& mute) {
     if (file->exists()) {
         QNetworkRequest req = prepareContentRequest("/files/upload");
 
@@ -612,25 +1649,19 @@ void QDropbox::upload(QFile* file, const QString& remotePath, const QString& mod
         req.setRawHeader("Dropbox-API-Arg", data);
 
         file->open(QIODevice::ReadOnly);
-        QNetworkReply* reply = m_network.post(req, file);
-        reply->setProperty("path", remotePath);
-        file->setParent(reply);
-        m_uploadsQueue.append(reply);
-
-        bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onUploaded()));
-        Q_ASSERT(res);
-        res = QObject::connect(reply, SIGNAL(uploadProgress(qint64,qint64)), this, SLOT(onUploadProgress(qint64,qint64)));
-        Q_ASSERT(res);
-        res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onUploadError(QNetworkReply::NetworkError)));
-        Q_ASSERT(res);
-        Q_UNUSED(res);
         emit uploadStarted(remotePath);
-    } else {
-        QString error = "Cannot open file: " + file->fileName() + "\n" + QString::number(file->error());
-        logger.error(error);
-        emit uploadFailed(error);
-        file->deleteLater();
+        QDropboxRequest* request = transfer(req, file, 0, SLOT(onUploaded()), &m_uploadsQueue);
+        request->setReportErrors(false);
+        file->setParent(request);
+        request->getContext().path = remotePath;
+        return request;
     }
+
+    QString error = "Cannot open file: " + file->fileName() + "\n" + QString::number(file->error());
+    logger.error(error);
+    emit uploadFailed(error);
+    file->deleteLater();
+    return rejected(QNetworkReply::ContentNotFoundError, error);
 }
 
 void QDropbox::onUploaded() {
@@ -649,21 +1680,15 @@ void QDropbox::onUploaded() {
             emit uploaded(file);
         }
         delete res;
-    }
-
-    m_uploadsQueue.removeAll(reply);
-    reply->deleteLater();
-}
-
-void QDropbox::onUploadError(QNetworkReply::NetworkError e) {
-    QNetworkReply* reply = getReply();
-    if (reply->error() != QNetworkReply::NoError) {
+    } else {
         emit uploadFailed(reply->errorString());
     }
-    Q_UNUSED(e);
+
+    m_uploadsQueue.removeAll(reply);
+    reply->deleteLater();
 }
 
-void QDropbox::uploadSessionStart(const QString& remotePath, const QByteArray& data , const bool& close) {
+QDropboxRequest* QDropbox::uploadSessionStart(const QString& remotePath, const QByteArray& data , const bool& close) {
     if (data.size()) {
         QNetworkRequest req = prepareContentRequest("/files/upload_session/start");
         QVariantMap map;
@@ -673,14 +1698,15 @@ void QDropbox::uploadSessionStart(const QString& remotePath, const QByteArray& d
         logger.debug(params);
         req.setRawHeader("Dropbox-API-Arg", params);
 
-        QNetworkReply* reply = m_network.post(req, data);
-        reply->setProperty("remote_path", remotePath);
-        bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onUploadSessionStarted()));
-        Q_ASSERT(res);
-        res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
-        Q_ASSERT(res);
-        Q_UNUSED(res);
+        QDropboxRequest* request = send(req, data, SLOT(onUploadSessionStarted()));
+        request->setIdempotent(false);
+        request->setTimeout(0);
+        request->setStallTimeout(m_stallTimeout);
+        request->getContext().path = remotePath;
+        return request;
     }
+
+    return rejected(QNetworkReply::ProtocolInvalidOperationError, "Nothing to upload");
 }
 
 void QDropbox::onUploadSessionStarted() {
@@ -690,14 +1716,14 @@ void QDropbox::onUploadSessionStarted() {
         bool res = false;
         QVariant data = QJson::Parser().parse(reply->readAll(), &res);
         if (res) {
-            emit uploadSessionStarted(reply->property("remote_path").toString(), data.toMap().value("session_id").toString());
+            emit uploadSessionStarted(context().path, data.toMap().value("session_id").toString());
         }
     }
 
     reply->deleteLater();
 }
 
-void QDropbox::uploadSessionAppend(const QString& sessionId, const QByteArray& data, const qint64& offset, const bool& close) {
+QDropboxRequest* QDropbox::uploadSessionAppend(const QString& sessionId, const QByteArray& data, const qint64& offset, const bool& close) {
     if (data.size()) {
         QNetworkRequest req = prepareContentRequest("/files/upload_session/append_v2");
         QVariantMap map;
@@ -711,27 +1737,28 @@ void QDropbox::uploadSessionAppend(const QString& sessionId, const QByteArray& d
         logger.debug(params);
         req.setRawHeader("Dropbox-API-Arg", params);
 
-        QNetworkReply* reply = m_network.post(req, data);
-        reply->setProperty("session_id", sessionId);
-        bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onUploadSessionAppended()));
-        Q_ASSERT(res);
-        res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
-        Q_ASSERT(res);
-        Q_UNUSED(res);
+        QDropboxRequest* request = send(req, data, SLOT(onUploadSessionAppended()));
+        request->setIdempotent(false);
+        request->setTimeout(0);
+        request->setStallTimeout(m_stallTimeout);
+        request->getContext().sessionId = sessionId;
+        return request;
     }
+
+    return rejected(QNetworkReply::ProtocolInvalidOperationError, "Nothing to upload");
 }
 
 void QDropbox::onUploadSessionAppended() {
     QNetworkReply* reply = getReply();
 
     if (reply->error() == QNetworkReply::NoError) {
-        emit uploadSessionAppended(reply->property("session_id").toString());
+        emit uploadSessionAppended(context().sessionId);
     }
 
     reply->deleteLater();
 }
 
-void QDropbox::uploadSessionFinish(const QString& sessionId, const QByteArray& data, const qint64& offset, const QString& path, const QString& mode, const bool& autorename, const bool& mute) {
+QDropboxRequest* QDropbox::uploadSessionFinish(const QString& sessionId, const QByteArray& data, const qint64& offset, const QString& path, const QString& mode, const bool& autorename, const bool& mute) {
     if (data.size()) {
         QNetworkRequest req = prepareContentRequest("/files/upload_session/finish");
         QVariantMap map;
@@ -750,13 +1777,14 @@ void QDropbox::uploadSessionFinish(const QString& sessionId, const QByteArray& d
         logger.debug(params);
         req.setRawHeader("Dropbox-API-Arg", params);
 
-        QNetworkReply* reply = m_network.post(req, data);
-        bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onUploadSessionFinished()));
-        Q_ASSERT(res);
-        res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
-        Q_ASSERT(res);
-        Q_UNUSED(res);
+        QDropboxRequest* request = send(req, data, SLOT(onUploadSessionFinished()));
+        request->setIdempotent(false);
+        request->setTimeout(0);
+        request->setStallTimeout(m_stallTimeout);
+        return request;
     }
+
+    return rejected(QNetworkReply::ProtocolInvalidOperationError, "Nothing to upload");
 }
 
 void QDropbox::onUploadSessionFinished() {
@@ -777,12 +1805,48 @@ void QDropbox::onUploadSessionFinished() {
     reply->deleteLater();
 }
 
-void QDropbox::onUploadProgress(qint64 loaded, qint64 total) {
+QDropboxRequest* QDropbox::uploadSessionFinishBatch(const QList<UploadSessionEntry>& entries) {
+    QNetworkRequest req = prepareRequest("/files/upload_session/finish_batch");
+    QVariantMap map;
+    QVariantList list;
+    QStringList paths;
+    foreach(UploadSessionEntry e, entries) {
+        list.append(e.toMap());
+        paths.append(e.path);
+    }
+    map["entries"] = list;
+
+    QByteArray data = QJson::Serializer().serialize(map);
+    logger.debug(data);
+
+    QDropboxRequest* request = send(req, data, SLOT(onUploadSessionFinishedBatch()));
+    request->setIdempotent(false);
+    request->getContext().paths = paths;
+    return request;
+}
+
+void QDropbox::onUploadSessionFinishedBatch() {
     QNetworkReply* reply = getReply();
-    emit uploadProgress(reply->property("path").toString(), loaded, total);
+
+    if (reply->error() == QNetworkReply::NoError) {
+        bool res = false;
+        QVariantMap map = QJson::Parser().parse(reply->readAll(), &res).toMap();
+        if (res) {
+            emit uploadSessionFinishedBatch(context().paths);
+            if (map.value(".tag").toString().compare("async_job_id") == 0) {
+                emit asyncJobLaunched(UPLOAD_SESSION_FINISH_BATCH_JOB, map.value("async_job_id").toString());
+            }
+        }
+    }
+
+    reply->deleteLater();
+}
+
+void QDropbox::onUploadProgress(qint64 loaded, qint64 total) {
+    emit uploadProgress(context().path, loaded, total);
 }
 
-void QDropbox::getTemporaryLink(const QString& path) {
+QDropboxRequest* QDropbox::getTemporaryLink(const QString& path) {
     QNetworkRequest req = prepareRequest("/files/get_temporary_link");
     QVariantMap map;
     map["path"] = path;
@@ -790,16 +1854,20 @@ void QDropbox::getTemporaryLink(const QString& path) {
     QByteArray data = QJson::Serializer().serialize(map);
     logger.debug(data);
 
-    QNetworkReply* reply = m_network.post(req, data);
-    bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onTemporaryLinkLoaded()));
-    Q_ASSERT(res);
-    res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
-    Q_ASSERT(res);
-    Q_UNUSED(res);
+    QString key = QString("/files/get_temporary_link").append(data);
+    QDropboxRequest* pending = coalesce(key);
+    if (pending != 0) {
+        return pending;
+    }
+
+    QDropboxRequest* request = send(req, data, SLOT(onTemporaryLinkLoaded()));
+    registerInflight(key, request);
+    return request;
 }
 
 void QDropbox::onTemporaryLinkLoaded() {
     QNetworkReply* reply = getReply();
+    unregisterInflight(reply);
 
     if (reply->error() == QNetworkReply::NoError) {
         bool res = false;
@@ -818,7 +1886,7 @@ void QDropbox::onTemporaryLinkLoaded() {
     reply->deleteLater();
 }
 
-void QDropbox::saveUrl(const QString& path, const QString& url) {
+QDropboxRequest* QDropbox::saveUrl(const QString& path, const QString& url) {
     QNetworkRequest req = prepareRequest("/files/save_url");
     QString filename = url.split("/").last();
     QVariantMap map;
@@ -828,12 +1896,9 @@ void QDropbox::saveUrl(const QString& path, const QString& url) {
     QByteArray data = QJson::Serializer().serialize(map);
     logger.debug(data);
 
-    QNetworkReply* reply = m_network.post(req, data);
-    bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onUrlSaved()));
-    Q_ASSERT(res);
-    res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
-    Q_ASSERT(res);
-    Q_UNUSED(res);
+    QDropboxRequest* request = send(req, data, SLOT(onUrlSaved()));
+    request->setIdempotent(false);
+    return request;
 }
 
 void QDropbox::onUrlSaved() {
@@ -846,7 +1911,7 @@ void QDropbox::onUrlSaved() {
     reply->deleteLater();
 }
 
-void QDropbox::getMetadata(const QString& path, const bool& includeMediaInfo, const bool& includeDeleted, const bool& includeHasExplicitSharedMembers) {
+QDropboxRequest* QDropbox::getMetadata(const QString& path, const bool& includeMediaInfo, const bool& includeDeleted, const bool& includeHasExplicitSharedMembers) {
     QNetworkRequest req = prepareRequest("/files/get_metadata");
     QVariantMap map;
     map["path"] = path;
@@ -856,16 +1921,21 @@ void QDropbox::getMetadata(const QString& path, const bool& includeMediaInfo, co
 
     QByteArray data = QJson::Serializer().serialize(map);
     logger.debug(data);
-    QNetworkReply* reply = m_network.post(req, data);
-    bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onMetadataReceived()));
-    Q_ASSERT(res);
-    res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
-    Q_ASSERT(res);
-    Q_UNUSED(res);
+
+    QString key = QString("/files/get_metadata").append(data);
+    QDropboxRequest* pending = coalesce(key);
+    if (pending != 0) {
+        return pending;
+    }
+
+    QDropboxRequest* request = send(req, data, SLOT(onMetadataReceived()));
+    registerInflight(key, request);
+    return request;
 }
 
 void QDropbox::onMetadataReceived() {
     QNetworkReply* reply = getReply();
+    unregisterInflight(reply);
 
     if (reply->error() == QNetworkReply::NoError) {
         bool res = false;
@@ -880,7 +1950,7 @@ void QDropbox::onMetadataReceived() {
     reply->deleteLater();
 }
 
-void QDropbox::addFolderMember(const QString& sharedFolderId, const QList<QDropboxMember>& members, const bool& quiet, const QString& customMessage) {
+QDropboxRequest* QDropbox::addFolderMember(const QString& sharedFolderId, const QList<QDropboxMember>& members, const bool& quiet, const QString& customMessage) {
     QNetworkRequest req = prepareRequest("/sharing/add_folder_member");
     QVariantMap map;
     map["shared_folder_id"] = sharedFolderId;
@@ -897,22 +1967,19 @@ void QDropbox::addFolderMember(const QString& sharedFolderId, const QList<QDropb
     QByteArray data = QJson::Serializer().serialize(map);
     logger.debug(data);
 
-    QNetworkReply* reply = m_network.post(req, data);
-    reply->setProperty("shared_folder_id", sharedFolderId);
-    bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onFolderMemberAdded()));
-    Q_ASSERT(res);
-    res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
-    Q_ASSERT(res);
-    Q_UNUSED(res);
+    QDropboxRequest* request = send(req, data, SLOT(onFolderMemberAdded()));
+    request->setIdempotent(false);
+    request->getContext().sharedFolderId = sharedFolderId;
+    return request;
 }
 
 void QDropbox::onFolderMemberAdded() {
     QNetworkReply* reply = getReply();
-    emit folderMemberAdded(reply->property("shared_folder_id").toString());
+    emit folderMemberAdded(context().sharedFolderId);
     reply->deleteLater();
 }
 
-void QDropbox::removeFolderMember(const QString& sharedFolderId, QDropboxMember& member, const bool& leaveACopy) {
+QDropboxRequest* QDropbox::removeFolderMember(const QString& sharedFolderId, QDropboxMember& member, const bool& leaveACopy) {
     QNetworkRequest req = prepareRequest("/sharing/remove_folder_member");
     QVariantMap map;
     map["shared_folder_id"] = sharedFolderId;
@@ -922,25 +1989,22 @@ void QDropbox::removeFolderMember(const QString& sharedFolderId, QDropboxMember&
     QByteArray data = QJson::Serializer().serialize(map);
     logger.debug(data);
 
-    QNetworkReply* reply = m_network.post(req, data);
-    reply->setProperty("shared_folder_id", sharedFolderId);
-    reply->setProperty("member", member.toMap());
-    bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onFolderMemberRemoved()));
-    Q_ASSERT(res);
-    res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
-    Q_ASSERT(res);
-    Q_UNUSED(res);
+    QDropboxRequest* request = send(req, data, SLOT(onFolderMemberRemoved()));
+    request->setIdempotent(false);
+    request->getContext().sharedFolderId = sharedFolderId;
+    request->getContext().member = member;
+    return request;
 }
 
 void QDropbox::onFolderMemberRemoved() {
     QNetworkReply* reply = getReply();
     QDropboxMember* member = new QDropboxMember(this);
-    member->fromMap(reply->property("member").toMap());
-    emit folderMemberRemoved(reply->property("shared_folder_id").toString(), member);
+    *member = context().member;
+    emit folderMemberRemoved(context().sharedFolderId, member);
     reply->deleteLater();
 }
 
-void QDropbox::updateFolderMember(const QString& sharedFolderId, QDropboxMember& member) {
+QDropboxRequest* QDropbox::updateFolderMember(const QString& sharedFolderId, QDropboxMember& member) {
     QNetworkRequest req = prepareRequest("/sharing/update_folder_member");
     QVariantMap map;
     map["shared_folder_id"] = sharedFolderId;
@@ -950,25 +2014,22 @@ void QDropbox::updateFolderMember(const QString& sharedFolderId, QDropboxMember&
     QByteArray data = QJson::Serializer().serialize(map);
     logger.debug(data);
 
-    QNetworkReply* reply = m_network.post(req, data);
-    reply->setProperty("shared_folder_id", sharedFolderId);
-    reply->setProperty("member", member.toMap());
-    bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onFolderMemberUpdated()));
-    Q_ASSERT(res);
-    res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
-    Q_ASSERT(res);
-    Q_UNUSED(res);
+    QDropboxRequest* request = send(req, data, SLOT(onFolderMemberUpdated()));
+    request->setIdempotent(false);
+    request->getContext().sharedFolderId = sharedFolderId;
+    request->getContext().member = member;
+    return request;
 }
 
 void QDropbox::onFolderMemberUpdated() {
     QNetworkReply* reply = getReply();
     QDropboxMember* member = new QDropboxMember(this);
-    member->fromMap(reply->property("member").toMap());
-    emit folderMemberUpdated(reply->property("shared_folder_id").toString(), member);
+    *member = context().member;
+    emit folderMemberUpdated(context().sharedFolderId, member);
     reply->deleteLater();
 }
 
-void QDropbox::listFolderMembers(const QString& sharedFolderId, const int& limit) {
+QDropboxRequest* QDropbox::listFolderMembers(const QString& sharedFolderId, const int& limit) {
     QNetworkRequest req = prepareRequest("/sharing/list_folder_members");
     QVariantMap map;
     map["shared_folder_id"] = sharedFolderId;
@@ -979,13 +2040,9 @@ void QDropbox::listFolderMembers(const QString& sharedFolderId, const int& limit
     QByteArray data = QJson::Serializer().serialize(map);
     logger.debug(data);
 
-    QNetworkReply* reply = m_network.post(req, data);
-    reply->setProperty("shared_folder_id", sharedFolderId);
-    bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onListFolderMembers()));
-    Q_ASSERT(res);
-    res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
-    Q_ASSERT(res);
-    Q_UNUSED(res);
+    QDropboxRequest* request = send(req, data, SLOT(onListFolderMembers()));
+    request->getContext().sharedFolderId = sharedFolderId;
+    return request;
 }
 
 void QDropbox::onListFolderMembers() {
@@ -1003,7 +2060,7 @@ void QDropbox::onListFolderMembers() {
                 m->fromMap(v.toMap());
                 members.append(m);
             }
-            emit listFolderMembersLoaded(reply->property("shared_folder_id").toString(), members, map.value("cursor", "").toString());
+            emit listFolderMembersLoaded(context().sharedFolderId, members, map.value("cursor", "").toString());
         }
         delete res;
     }
@@ -1011,7 +2068,7 @@ void QDropbox::onListFolderMembers() {
     reply->deleteLater();
 }
 
-void QDropbox::shareFolder(const QString& path, const bool& forceAsync, const QDropboxAclUpdatePolicy& aclUpdatePolicy,  const QDropboxMemberPolicy& memberPolicy,
+QDropboxRequest* QDropbox::shareFolder(const QString& path, const bool& forceAsync, const QDropboxAclUpdatePolicy& aclUpdatePolicy,  const QDropboxMemberPolicy& memberPolicy,
             const QDropboxSharedLinkPolicy& sharedLinkPolicy, const QDropboxViewerInfoPolicy& viewerInfoPolicy,
             const QList<QDropboxFolderAction>& folderActions) {
 
@@ -1052,13 +2109,10 @@ void QDropbox::shareFolder(const QString& path, const bool& forceAsync, const QD
     QByteArray data = QJson::Serializer().serialize(map);
     logger.debug(data);
 
-    QNetworkReply* reply = m_network.post(req, data);
-    reply->setProperty("path", path);
-    bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onFolderShared()));
-    Q_ASSERT(res);
-    res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
-    Q_ASSERT(res);
-    Q_UNUSED(res);
+    QDropboxRequest* request = send(req, data, SLOT(onFolderShared()));
+    request->setIdempotent(false);
+    request->getContext().path = path;
+    return request;
 }
 
 void QDropbox::onFolderShared() {
@@ -1073,7 +2127,10 @@ void QDropbox::onFolderShared() {
             // TODO: process full data in the future
 
             QVariantMap map = data.toMap();
-            emit folderShared(reply->property("path").toString(), map.value("shared_folder_id").toString());
+            emit folderShared(context().path, map.value("shared_folder_id").toString());
+            if (map.value(".tag").toString().compare("async_job_id") == 0) {
+                emit asyncJobLaunched(SHARE_FOLDER_JOB, map.value("async_job_id").toString());
+            }
         }
         delete res;
     }
@@ -1081,7 +2138,7 @@ void QDropbox::onFolderShared() {
     reply->deleteLater();
 }
 
-void QDropbox::unshareFolder(const QString& sharedFolderId, const bool& leaveACopy) {
+QDropboxRequest* QDropbox::unshareFolder(const QString& sharedFolderId, const bool& leaveACopy) {
     QNetworkRequest req = prepareRequest("/sharing/unshare_folder");
     QVariantMap map;
     map["shared_folder_id"] = sharedFolderId;
@@ -1090,13 +2147,10 @@ void QDropbox::unshareFolder(const QString& sharedFolderId, const bool& leaveACo
     QByteArray data = QJson::Serializer().serialize(map);
     logger.debug(data);
 
-    QNetworkReply* reply = m_network.post(req, data);
-    reply->setProperty("shared_folder_id", sharedFolderId);
-    bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onFolderUnshared()));
-    Q_ASSERT(res);
-    res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
-    Q_ASSERT(res);
-    Q_UNUSED(res);
+    QDropboxRequest* request = send(req, data, SLOT(onFolderUnshared()));
+    request->setIdempotent(false);
+    request->getContext().sharedFolderId = sharedFolderId;
+    return request;
 }
 
 void QDropbox::onFolderUnshared() {
@@ -1106,7 +2160,7 @@ void QDropbox::onFolderUnshared() {
         UnshareJobStatus status;
         status.asyncJobId = "";
         status.status = UnshareJobStatus::InProgress;
-        status.sharedFolderId = reply->property("shared_folder_id").toString();
+        status.sharedFolderId = context().sharedFolderId;
         bool res = false;
         QVariant data = QJson::Parser().parse(reply->readAll(), &res);
         if (res) {
@@ -1119,12 +2173,15 @@ void QDropbox::onFolderUnshared() {
         }
 
         emit folderUnshared(status);
+        if (!status.asyncJobId.isEmpty()) {
+            emit asyncJobLaunched(UNSHARE_FOLDER_JOB, status.asyncJobId);
+        }
     }
 
     reply->deleteLater();
 }
 
-void QDropbox::createSharedLink(const QString& path, const bool& shortUrl, const QDropboxPendingUpload& pendingUpload) {
+QDropboxRequest* QDropbox::createSharedLink(const QString& path, const bool& shortUrl, const QDropboxPendingUpload& pendingUpload) {
     QNetworkRequest req = prepareRequest("/sharing/create_shared_link");
     QVariantMap map;
     map["path"] = path;
@@ -1136,12 +2193,9 @@ void QDropbox::createSharedLink(const QString& path, const bool& shortUrl, const
     QByteArray data = QJson::Serializer().serialize(map);
     logger.debug(data);
 
-    QNetworkReply* reply = m_network.post(req, data);
-    bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onSharedLinkCreated()));
-    Q_ASSERT(res);
-    res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
-    Q_ASSERT(res);
-    Q_UNUSED(res);
+    QDropboxRequest* request = send(req, data, SLOT(onSharedLinkCreated()));
+    request->setIdempotent(false);
+    return request;
 }
 
 void QDropbox::onSharedLinkCreated() {
@@ -1160,7 +2214,7 @@ void QDropbox::onSharedLinkCreated() {
     reply->deleteLater();
 }
 
-void QDropbox::revokeSharedLink(const QString& sharedLinkUrl) {
+QDropboxRequest* QDropbox::revokeSharedLink(const QString& sharedLinkUrl) {
     QNetworkRequest req = prepareRequest("/sharing/revoke_shared_link");
     QVariantMap map;
     map["url"] = sharedLinkUrl;
@@ -1168,26 +2222,23 @@ void QDropbox::revokeSharedLink(const QString& sharedLinkUrl) {
     QByteArray data = QJson::Serializer().serialize(map);
     logger.debug(data);
 
-    QNetworkReply* reply = m_network.post(req, data);
-    reply->setProperty("url", sharedLinkUrl);
-    bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onSharedLinkRevoked()));
-    Q_ASSERT(res);
-    res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
-    Q_ASSERT(res);
-    Q_UNUSED(res);
+    QDropboxRequest* request = send(req, data, SLOT(onSharedLinkRevoked()));
+    request->setIdempotent(false);
+    request->getContext().url = sharedLinkUrl;
+    return request;
 }
 
 void QDropbox::onSharedLinkRevoked() {
     QNetworkReply* reply = getReply();
 
     if (reply->error() == QNetworkReply::NoError) {
-        emit sharedLinkRevoked(reply->property("url").toString());
+        emit sharedLinkRevoked(context().url);
     }
 
     reply->deleteLater();
 }
 
-void QDropbox::getSharedLinks(const QString& path) {
+QDropboxRequest* QDropbox::getSharedLinks(const QString& path) {
     QNetworkRequest req = prepareRequest("/sharing/get_shared_links");
     QVariantMap map;
     map["path"] = path;
@@ -1195,12 +2246,7 @@ void QDropbox::getSharedLinks(const QString& path) {
     QByteArray data = QJson::Serializer().serialize(map);
     logger.debug(data);
 
-    QNetworkReply* reply = m_network.post(req, data);
-    bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onSharedLinksLoaded()));
-    Q_ASSERT(res);
-    res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
-    Q_ASSERT(res);
-    Q_UNUSED(res);
+    return send(req, data, SLOT(onSharedLinksLoaded()));
 }
 
 void QDropbox::onSharedLinksLoaded() {
@@ -1224,7 +2270,7 @@ void QDropbox::onSharedLinksLoaded() {
     reply->deleteLater();
 }
 
-void QDropbox::checkJobStatus(const QString& asyncJobId) {
+QDropboxRequest* QDropbox::checkJobStatus(const QString& asyncJobId) {
     QNetworkRequest req = prepareRequest("/sharing/check_job_status");
     QVariantMap map;
     map["async_job_id"] = asyncJobId;
@@ -1232,11 +2278,10 @@ void QDropbox::checkJobStatus(const QString& asyncJobId) {
     QByteArray data = QJson::Serializer().serialize(map);
     logger.debug(data);
 
-    QNetworkReply* reply = m_network.post(req, data);
-    reply->setProperty("async_job_id", asyncJobId);
-    bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onJobStatusChecked()));
-    Q_ASSERT(res);
-    Q_UNUSED(res);
+    QDropboxRequest* request = send(req, data, SLOT(onJobStatusChecked()));
+    request->setReportErrors(false);
+    request->getContext().asyncJobId = asyncJobId;
+    return request;
 }
 
 void QDropbox::onJobStatusChecked() {
@@ -1249,7 +2294,7 @@ void QDropbox::onJobStatusChecked() {
             QVariantMap map = data.toMap();
             if (map.contains(".tag")) {
                 UnshareJobStatus status;
-                status.asyncJobId = reply->property("async_job_id").toString();
+                status.asyncJobId = context().asyncJobId;
                 status.status = map.value(".tag").toString().compare("complete") == 0 ? UnshareJobStatus::Complete : UnshareJobStatus::InProgress;
                 emit jobStatusChecked(status);
             }
@@ -1266,19 +2311,90 @@ void QDropbox::onJobStatusChecked() {
     reply->deleteLater();
 }
 
-void QDropbox::getAccount(const QString& accountId) {
+QDropboxRequest* QDropbox::checkJob(const QString& type, const QString& asyncJobId) {
+    QString apiMethod;
+    if (type.compare(DELETE_BATCH_JOB) == 0) {
+        apiMethod = "/files/delete_batch/check";
+    } else if (type.compare(MOVE_BATCH_JOB) == 0) {
+        apiMethod = "/files/move_batch/check";
+    } else if (type.compare(MOVE_BATCH_V2_JOB) == 0) {
+        apiMethod = "/files/move_batch/check_v2";
+    } else if (type.compare(COPY_BATCH_V2_JOB) == 0) {
+        apiMethod = "/files/copy_batch/check_v2";
+    } else if (type.compare(UPLOAD_SESSION_FINISH_BATCH_JOB) == 0) {
+        apiMethod = "/files/upload_session/finish_batch/check";
+    } else if (type.compare(SHARE_FOLDER_JOB) == 0) {
+        apiMethod = "/sharing/check_share_job_status";
+    } else if (type.compare(UNSHARE_FOLDER_JOB) == 0) {
+        apiMethod = "/sharing/check_job_status";
+    } else {
+        logger.error("Unknown async job type: " + type);
+        return rejected(QNetworkReply::ProtocolInvalidOperationError, "Unknown async job type: " + type);
+    }
+
+    // a job is checked on the account that launched it
+    QString scopedToken = m_scopedToken;
+    m_scopedToken = m_jobTokens.value(asyncJobId, m_scopedToken);
+    QNetworkRequest req = prepareRequest(apiMethod);
+    QVariantMap map;
+    map["async_job_id"] = asyncJobId;
+
+    QDropboxRequest* request = send(req, QJson::Serializer().serialize(map), SLOT(onAsyncJobChecked()));
+    request->setReportErrors(false);
+    request->getContext().type = type;
+    request->getContext().asyncJobId = asyncJobId;
+    m_scopedToken = scopedToken;
+    return request;
+}
+
+void QDropbox::onAsyncJobLaunched(const QString& type, const QString& asyncJobId) {
+    Q_UNUSED(type);
+    m_jobTokens.insert(asyncJobId, token());
+}
+
+void QDropbox::onAsyncJobChecked() {
+    QNetworkReply* reply = getReply();
+
+    AsyncJobStatus status;
+    status.type = context().type;
+    status.asyncJobId = context().asyncJobId;
+
+    bool res = false;
+    QVariant data = QJson::Parser().parse(reply->readAll(), &res);
+    int httpStatus = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+    if (reply->error() == QNetworkReply::NoError && res) {
+        status.result = data.toMap();
+        QString tag = status.result.value(".tag").toString();
+        if (tag.compare("complete") == 0) {
+            status.status = AsyncJobStatus::Complete;
+            status.entries = status.result.value("entries").toList();
+        } else if (tag.compare("in_progress") != 0) {
+            status.status = AsyncJobStatus::Failed;
+        }
+        emit asyncJobChecked(status);
+    } else if (httpStatus == 409) {
+        // the job id is unknown or the job itself failed
+        status.status = AsyncJobStatus::Failed;
+        status.result = data.toMap();
+        emit asyncJobChecked(status);
+    } else {
+        logger.error(reply->errorString());
+    }
+
+    reply->deleteLater();
+}
+
+QDropboxJobTracker* QDropbox::getJobTracker() const { return m_pJobTracker; }
+
+QDropboxRequest* QDropbox::getAccount(const QString& accountId) {
     QNetworkRequest req = prepareRequest("/users/get_account");
     QVariantMap map;
     map["account_id"] = accountId;
 
     QJson::Serializer serializer;
 
-    QNetworkReply* reply = m_network.post(req, serializer.serialize(map));
-    bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onAccountLoaded()));
-    Q_ASSERT(res);
-    res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
-    Q_ASSERT(res);
-    Q_UNUSED(res);
+    return send(req, serializer.serialize(map), SLOT(onAccountLoaded()));
 }
 
 void QDropbox::onAccountLoaded() {
@@ -1297,7 +2413,7 @@ void QDropbox::onAccountLoaded() {
     reply->deleteLater();
 }
 
-void QDropbox::getAccountBatch(const QStringList& accountIds) {
+QDropboxRequest* QDropbox::getAccountBatch(const QStringList& accountIds) {
     QNetworkRequest req = prepareRequest("/users/get_account_batch");
     QVariantMap map;
     map["account_ids"] = accountIds;
@@ -1305,12 +2421,7 @@ void QDropbox::getAccountBatch(const QStringList& accountIds) {
     QByteArray data = QJson::Serializer().serialize(map);
     logger.debug(data);
 
-    QNetworkReply* reply = m_network.post(req, data);
-    bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onAccountBatchLoaded()));
-    Q_ASSERT(res);
-    res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
-    Q_ASSERT(res);
-    Q_UNUSED(res);
+    return send(req, data, SLOT(onAccountBatchLoaded()));
 }
 
 void QDropbox::onAccountBatchLoaded() {
@@ -1334,14 +2445,9 @@ void QDropbox::onAccountBatchLoaded() {
     reply->deleteLater();
 }
 
-void QDropbox::getCurrentAccount() {
+QDropboxRequest* QDropbox::getCurrentAccount() {
     QNetworkRequest req = prepareRequest("/users/get_current_account");
-    QNetworkReply* reply = m_network.post(req, "null");
-    bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onCurrentAccountLoaded()));
-    Q_ASSERT(res);
-    res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
-    Q_ASSERT(res);
-    Q_UNUSED(res);
+    return send(req, "null", SLOT(onCurrentAccountLoaded()));
 }
 
 void QDropbox::onCurrentAccountLoaded() {
@@ -1360,14 +2466,9 @@ void QDropbox::onCurrentAccountLoaded() {
     reply->deleteLater();
 }
 
-void QDropbox::getSpaceUsage() {
+QDropboxRequest* QDropbox::getSpaceUsage() {
     QNetworkRequest req = prepareRequest("/users/get_space_usage");
-    QNetworkReply* reply = m_network.post(req, "null");
-    bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onSpaceUsageLoaded()));
-    Q_ASSERT(res);
-    res = QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
-    Q_ASSERT(res);
-    Q_UNUSED(res);
+    return send(req, "null", SLOT(onSpaceUsageLoaded()));
 }
 
 void QDropbox::onSpaceUsageLoaded() {
@@ -1388,6 +2489,17 @@ void QDropbox::onSpaceUsageLoaded() {
 
 void QDropbox::onError(QNetworkReply::NetworkError e) {
     QNetworkReply* reply = getReply();
+    QDropboxRequest* request = m_requests.value(reply, reply == m_pCurrentReply ? m_pCurrentRequest : 0);
+    if (request != 0 && request->isCancelled()) {
+        // transfers report through the reply as well, a cancel never reaches error()
+        return;
+    }
+    if (request != 0 && request->isTimedOut()) {
+        logger.error("Request timed out: " + reply->url().toString());
+        emit error(QNetworkReply::TimeoutError, "Request timed out");
+        return;
+    }
+
     QString errorString = reply->errorString();
     logger.error(errorString);
     logger.error(e);
@@ -1409,6 +2521,47 @@ void QDropbox::init() {
     m_accessToken = "";
     m_downloadsFolder = QDir::currentPath() + "/downloads";
     m_readBufferSize = 5242880; // 5MB
+    m_maxBufferedPages = 4;
+    m_coalesceRequests = true;
+    m_pThumbnailCache = 0;
+    m_pBlockStore = 0;
+    m_thumbnailBatching = false;
+    m_thumbnailBatchTimer.setSingleShot(true);
+    m_thumbnailBatchTimer.setInterval(THUMBNAIL_BATCH_WINDOW);
+    bool res = QObject::connect(&m_thumbnailBatchTimer, SIGNAL(timeout()), this, SLOT(flushThumbnailBatch()));
+    Q_ASSERT(res);
+    Q_UNUSED(res);
+    m_writeCombining = false;
+    m_writeCombineTimer.setSingleShot(true);
+    m_writeCombineTimer.setInterval(WRITE_COMBINE_WINDOW);
+    res = QObject::connect(&m_writeCombineTimer, SIGNAL(timeout()), this, SLOT(flushWrites()));
+    Q_ASSERT(res);
+    m_pNetwork = new QNetworkAccessManager(this);
+    res = QObject::connect(&m_keepWarmTimer, SIGNAL(timeout()), this, SLOT(warmUp()));
+    Q_ASSERT(res);
+    m_http2Allowed = true;
+    m_maxConnectionsPerHost = 0;
+    m_maxRetries = MAX_RETRIES;
+    m_requestTimeout = REQUEST_TIMEOUT;
+    m_stallTimeout = STALL_TIMEOUT;
+    m_pCurrentRequest = 0;
+    m_watchdogTimer.setInterval(WATCHDOG_INTERVAL);
+    res = QObject::connect(&m_watchdogTimer, SIGNAL(timeout()), this, SLOT(checkTimeouts()));
+    Q_ASSERT(res);
+    m_pCurrentReply = 0;
+    m_admissionTimer.setSingleShot(true);
+    res = QObject::connect(&m_admissionTimer, SIGNAL(timeout()), this, SLOT(admit()));
+    Q_ASSERT(res);
+    m_jitterState = (quint32) QDateTime::currentMSecsSinceEpoch() ^ (quint32) (quintptr) this;
+    if (m_jitterState == 0) {
+        m_jitterState = 1;
+    }
+    res = QObject::connect(this, SIGNAL(asyncJobLaunched(const QString&, const QString&)), this, SLOT(onAsyncJobLaunched(const QString&, const QString&)));
+    Q_ASSERT(res);
+    m_pJobTracker = new QDropboxJobTracker(this, this);
+    res = QObject::connect(m_pJobTracker, SIGNAL(finished(const AsyncJobStatus&)), this, SLOT(onAsyncJobFinished(const AsyncJobStatus&)));
+    Q_ASSERT(res);
+    m_pagingId = 0;
     generateFullUrl();
     generateFullContentUrl();
     generateFullNotifyUrl();
@@ -1435,9 +2588,13 @@ QNetworkRequest QDropbox::prepareRequest(const QString& apiMethod) {
 
     QNetworkRequest req;
     req.setUrl(url);
-    req.setRawHeader("Authorization", QString("Bearer ").append(m_accessToken).toUtf8());
+    req.setRawHeader("Authorization", QString("Bearer ").append(token()).toUtf8());
     req.setRawHeader("Content-Type", "application/json");
 
+#if QT_VERSION >= 0x050800
+    req.setAttribute(QNetworkRequest::HTTP2AllowedAttribute, m_http2Allowed);
+#endif
+
     logger.debug(url);
 
     return req;
@@ -1448,9 +2605,13 @@ QNetworkRequest QDropbox::prepareContentRequest(const QString& apiMethod, const
 
     QNetworkRequest req;
     req.setUrl(url);
-    req.setRawHeader("Authorization", QString("Bearer ").append(m_accessToken).toUtf8());
+    req.setRawHeader("Authorization", QString("Bearer ").append(token()).toUtf8());
     req.setRawHeader("Content-Type", "application/octet-stream");
 
+#if QT_VERSION >= 0x050800
+    req.setAttribute(QNetworkRequest::HTTP2AllowedAttribute, m_http2Allowed);
+#endif
+
     if (log) {
         logger.debug(url);
     }
@@ -1465,6 +2626,10 @@ QNetworkRequest QDropbox::prepareNotifyRequest(const QString& apiMethod, const b
     req.setUrl(url);
     req.setRawHeader("Content-Type", "application/json");
 
+#if QT_VERSION >= 0x050800
+    req.setAttribute(QNetworkRequest::HTTP2AllowedAttribute, m_http2Allowed);
+#endif
+
     if (log) {
         logger.debug(url);
     }
@@ -1473,10 +2638,445 @@ QNetworkRequest QDropbox::prepareNotifyRequest(const QString& apiMethod, const b
 }
 
 QNetworkReply* QDropbox::getReply() {
-    return qobject_cast<QNetworkReply*>(QObject::sender());
+    QNetworkReply* reply = qobject_cast<QNetworkReply*>(QObject::sender());
+    return reply != 0 ? reply : m_pCurrentReply;
+}
+
+QDropboxRequestContext& QDropbox::context() {
+    QDropboxRequest* request = m_pCurrentRequest != 0 ? m_pCurrentRequest : m_requests.value(getReply(), 0);
+    if (request == 0) {
+        m_noContext = QDropboxRequestContext();
+        return m_noContext;
+    }
+    return request->getContext();
+}
+
+QString QDropbox::token() const {
+    // follow-ups of a call run on the account of that call, not on the one the client holds now
+    if (!m_scopedToken.isNull()) {
+        return m_scopedToken;
+    }
+    if (m_pCurrentRequest != 0 && !m_pCurrentRequest->getNamespace().isEmpty()) {
+        return m_pCurrentRequest->getNamespace();
+    }
+    return m_accessToken;
+}
+
+QDropboxRequest* QDropbox::send(const QNetworkRequest& req, const QByteArray& data, const char* slot) {
+    QDropboxRequest* request = new QDropboxRequest(req, data, slot, this);
+    request->setNamespace(token());
+    request->setTimeout(m_requestTimeout);
+    bool res = QObject::connect(request, SIGNAL(cancelled()), this, SLOT(onRequestCancelled()));
+    Q_ASSERT(res);
+    Q_UNUSED(res);
+
+    m_pendingRequests.append(request);
+    admit();
+    return request;
+}
+
+QDropboxRequest* QDropbox::resolved(const QVariant& value) {
+    QDropboxRequest* request = new QDropboxRequest(QNetworkRequest(), QByteArray(), 0, this);
+    request->setNamespace(token());
+    request->resolve(value);
+    settleLater(request);
+    return request;
+}
+
+QDropboxRequest* QDropbox::rejected(const QNetworkReply::NetworkError& error, const QString& errorString) {
+    QDropboxRequest* request = new QDropboxRequest(QNetworkRequest(), QByteArray(), 0, this);
+    request->setNamespace(token());
+    request->reject(error, errorString);
+    settleLater(request);
+    return request;
+}
+
+void QDropbox::settleLater(QDropboxRequest* request) {
+    // a call that needs no network still hands out a handle, finished once the caller had a chance to add continuations
+    m_settledRequests.append(request);
+    if (m_settledRequests.size() == 1) {
+        QMetaObject::invokeMethod(this, "onSettledDue", Qt::QueuedConnection);
+    }
+}
+
+void QDropbox::onSettledDue() {
+    while (m_settledRequests.size()) {
+        QDropboxRequest* request = m_settledRequests.takeFirst();
+        if (request->isCancelled()) {
+            request->reject(QNetworkReply::OperationCanceledError, "Request cancelled");
+        }
+        request->finish();
+        request->deleteLater();
+    }
+}
+
+QDropboxRequest* QDropbox::transfer(const QNetworkRequest& req, QIODevice* body, const char* readSlot, const char* slot, QList<QNetworkReply*>* queue) {
+    // admitted like any call, but its body is streamed as it goes and never sent twice
+    QDropboxRequest* request = new QDropboxRequest(req, QByteArray(), slot, this);
+    request->setNamespace(token());
+    request->setIdempotent(false);
+    request->setStallTimeout(m_stallTimeout);
+    bool res = QObject::connect(request, SIGNAL(cancelled()), this, SLOT(onRequestCancelled()));
+    Q_ASSERT(res);
+    Q_UNUSED(res);
+
+    Transfer entry;
+    entry.body = body;
+    entry.readSlot = readSlot;
+    entry.queue = queue;
+    m_transfers.insert(request, entry);
+
+    m_pendingRequests.append(request);
+    admit();
+    return request;
+}
+
+void QDropbox::onRequestCancelled() {
+    QDropboxRequest* request = qobject_cast<QDropboxRequest*>(QObject::sender());
+    bool combined = m_pendingDeletes.removeAll(request) > 0;
+    foreach(int flags, m_pendingMoves.keys()) {
+        combined = m_pendingMoves[flags].removeAll(request) > 0 || combined;
+    }
+    if (combined) {
+        // not flushed yet, the write is simply left out of the batch
+        request->reject(QNetworkReply::OperationCanceledError, "Request cancelled");
+        request->finish();
+        request->deleteLater();
+        return;
+    }
+
+    if (request != 0 && m_thumbnailRequests.remove(request->getContext().coalesceKey, request) > 0) {
+        // a caller waiting for a thumbnail only leaves, the thumbnail is still fetched and cached
+        request->reject(QNetworkReply::OperationCanceledError, "Request cancelled");
+        request->finish();
+        request->deleteLater();
+        return;
+    }
+
+    QDropboxRequest* inflight = request != 0 ? m_inflight.value(request->getContext().coalesceKey, 0) : 0;
+    if (inflight != 0 && inflight != request && inflight->getContext().joined.removeAll(request) > 0) {
+        // a joined caller only leaves, the call goes on for the others
+        request->reject(QNetworkReply::OperationCanceledError, "Request cancelled");
+        request->finish();
+        request->deleteLater();
+        return;
+    }
+
+    if (request == 0 || !m_pendingRequests.removeAll(request)) {
+        // already on the wire, the aborted reply goes through the usual handler
+        return;
+    }
+    if (m_transfers.remove(request) > 0) {
+        // a transfer that never went out leaves its sink alone and no partial file behind
+        QIODevice* device = request->getContext().device;
+        if (device != 0 && m_sinks.value(device, 0) == request) {
+            m_sinks.remove(device);
+            QObject::disconnect(device, SIGNAL(bytesWritten(qint64)), this, SLOT(onSinkWritten(qint64)));
+        }
+        QFile* file = qobject_cast<QFile*>(device);
+        if (file != 0 && !request->getContext().localPath.isEmpty()) {
+            file->remove();
+        }
+    }
+
+    // a batch stands in for every thumbnail it carries
+    foreach(QString key, m_inflight.keys(request)) {
+        m_inflight.remove(key);
+    }
+    settleThumbnail(request->getContext().coalesceKey, QImage(), QNetworkReply::OperationCanceledError, "Request cancelled");
+    foreach(QVariant pending, request->getContext().entries) {
+        settleThumbnail(pending.toMap().value("key").toString(), QImage(), QNetworkReply::OperationCanceledError, "Request cancelled");
+    }
+    request->reject(QNetworkReply::OperationCanceledError, "Request cancelled");
+    failCombinedWrite(request->getContext().batched, QNetworkReply::OperationCanceledError, "Request cancelled");
+    request->finish();
+    settleJoined(request);
+    request->deleteLater();
+}
+
+void QDropbox::checkTimeouts() {
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    foreach(QDropboxRequest* request, m_requests.values()) {
+        if (request->isExpired(now)) {
+            logger.warn("Request timed out: " + request->getRequest().url().toString());
+            request->expire();
+        }
+    }
+
+    if (m_requests.isEmpty()) {
+        m_watchdogTimer.stop();
+    }
+}
+
+void QDropbox::warmUp() {
+    QStringList urls;
+    urls << m_url << m_contentUrl << m_notifyUrl;
+    foreach(QString u, urls) {
+        QUrl url(u);
+#if QT_VERSION >= 0x050200
+        m_pNetwork->connectToHostEncrypted(url.host(), url.port(443));
+#else
+        // no way to just open a connection before Qt 5.2, a bodyless request leaves one in the pool
+        QNetworkReply* reply = m_pNetwork->head(QNetworkRequest(url));
+        bool res = QObject::connect(reply, SIGNAL(finished()), reply, SLOT(deleteLater()));
+        Q_ASSERT(res);
+        Q_UNUSED(res);
+#endif
+    }
+}
+
+void QDropbox::admit() {
+    m_admissionTimer.stop();
+
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    qint64 wait = -1;
+    QStringList accounts;
+    QHash<QString, QList<QDropboxRequest*> > ready;
+    foreach(QDropboxRequest* request, m_pendingRequests) {
+        if (request->getNotBefore() > now) {
+            wait = wait < 0 ? request->getNotBefore() - now : qMin(wait, request->getNotBefore() - now);
+            continue;
+        }
+        if (!ready.contains(request->getNamespace())) {
+            accounts.append(request->getNamespace());
+        }
+        ready[request->getNamespace()].append(request);
+    }
+
+    // one request per account and round, so a busy account cannot starve the others
+    while (!accounts.isEmpty()) {
+        QString account = accounts.takeFirst();
+        QList<QDropboxRequest*>& queue = ready[account];
+        QDropboxRequest* request = 0;
+        for (int i = 0; i < queue.size() && request == 0; i++) {
+            QString host = queue.at(i)->getRequest().url().host();
+            int limit = getMaxConnectionsPerHost(host);
+            if (limit <= 0 || m_hostLoad.value(host, 0) < limit) {
+                request = queue.takeAt(i);
+            }
+        }
+        if (request == 0) {
+            continue;
+        }
+
+        QSharedPointer<QDropboxRateLimiter> limiter = QDropboxRateLimiter::forNamespace(account);
+        int delay = limiter->acquire();
+        if (delay > 0) {
+            wait = wait < 0 ? delay : qMin(wait, (qint64) delay);
+            continue;
+        }
+        m_pendingRequests.removeOne(request);
+        dispatch(request);
+        if (!queue.isEmpty()) {
+            accounts.append(account);
+        }
+    }
+
+    if (wait >= 0) {
+        m_admissionTimer.start((int) wait);
+    }
+}
+
+void QDropbox::dispatch(QDropboxRequest* request) {
+    request->setAttempts(request->getAttempts() + 1);
+
+    Transfer entry = m_transfers.value(request);
+    QNetworkReply* reply = entry.body != 0 ? m_pNetwork->post(request->getRequest(), entry.body) : m_pNetwork->post(request->getRequest(), request->getData());
+    request->setReply(reply);
+    m_hostLoad[reply->url().host()]++;
+    m_requests.insert(reply, request);
+    bool res = QObject::connect(reply, SIGNAL(finished()), this, SLOT(onRequestFinished()));
+    Q_ASSERT(res);
+    if (m_transfers.contains(request)) {
+        if (entry.queue != 0) {
+            entry.queue->append(reply);
+        }
+        if (entry.body != 0) {
+            res = QObject::connect(reply, SIGNAL(uploadProgress(qint64,qint64)), this, SLOT(onUploadProgress(qint64,qint64)));
+            Q_ASSERT(res);
+        } else {
+            reply->setReadBufferSize(m_readBufferSize);
+            res = QObject::connect(reply, SIGNAL(downloadProgress(qint64,qint64)), this, SLOT(onDownloadProgress(qint64,qint64)));
+            Q_ASSERT(res);
+        }
+        if (!entry.readSlot.isEmpty()) {
+            res = QObject::connect(reply, SIGNAL(readyRead()), this, entry.readSlot.constData());
+            Q_ASSERT(res);
+        }
+    }
+    res = QObject::connect(reply, SIGNAL(downloadProgress(qint64,qint64)), request, SLOT(touch()));
+    Q_ASSERT(res);
+    res = QObject::connect(reply, SIGNAL(uploadProgress(qint64,qint64)), request, SLOT(touch()));
+    Q_ASSERT(res);
+    Q_UNUSED(res);
+
+    if (!m_watchdogTimer.isActive()) {
+        m_watchdogTimer.start();
+    }
+}
+
+void QDropbox::onRequestFinished() {
+    QNetworkReply* reply = getReply();
+    QDropboxRequest* request = m_requests.take(reply);
+    if (request == 0) {
+        reply->deleteLater();
+        return;
+    }
+
+    QString host = request->getRequest().url().host();
+    if (--m_hostLoad[host] <= 0) {
+        m_hostLoad.remove(host);
+    }
+    if (!m_pendingRequests.isEmpty()) {
+        admit();
+    }
+
+    int delay = retryDelay(request, reply);
+    if (delay >= 0) {
+        logger.info("Retrying " + reply->url().path() + " in " + QString::number(delay) + " ms, attempt " + QString::number(request->getAttempts()));
+        request->setReply(0);
+        request->setNotBefore(QDateTime::currentMSecsSinceEpoch() + delay);
+        m_pendingRequests.append(request);
+        reply->deleteLater();
+        admit();
+        return;
+    }
+
+    settle(request, reply);
+    m_pCurrentReply = reply;
+    m_pCurrentRequest = request;
+    if (request->isCancelled()) {
+        // the caller asked for it, only the handle reports it
+        logger.debug("Request cancelled: " + reply->url().path());
+    } else if (reply->error() != QNetworkReply::NoError && request->isReportErrors()) {
+        onError(reply->error());
+    }
+    QMetaObject::invokeMethod(this, request->getSlot().constData(), Qt::DirectConnection);
+    m_pCurrentReply = 0;
+    m_pCurrentRequest = 0;
+
+    m_transfers.remove(request);
+    request->finish();
+    settleJoined(request);
+    request->deleteLater();
+}
+
+int QDropbox::retryDelay(QDropboxRequest* request, QNetworkReply* reply) {
+    int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    // a 429 is rejected before any processing, so only then non idempotent calls are safe to send again
+    bool retryable = status == 429 || (status == 503 && request->isIdempotent());
+    if (request->isCancelled() || request->isTimedOut()) {
+        return -1;
+    }
+    if (!retryable || request->getAttempts() > m_maxRetries) {
+        return -1;
+    }
+
+    bool ok = false;
+    int seconds = QString(reply->rawHeader("Retry-After")).trimmed().toInt(&ok);
+    if (!ok) {
+        bool res = false;
+        QVariantMap error = QJson::Parser().parse(reply->peek(reply->bytesAvailable()), &res).toMap().value("error").toMap();
+        seconds = res ? error.value("retry_after").toInt() : 0;
+    }
+
+    int delay = seconds > 0 ? seconds * 1000 : qMin(RETRY_MAX_DELAY, RETRY_BASE_DELAY << qMin(request->getAttempts() - 1, 10));
+    delay += jitter(delay / 2 + 1);
+    if (status == 429) {
+        QSharedPointer<QDropboxRateLimiter> limiter = QDropboxRateLimiter::forNamespace(request->getNamespace());
+        limiter->pause(delay);
+    }
+    // the body of a transfer has been streamed already, the account backs off but the caller sends it again
+    if (m_transfers.contains(request)) {
+        return -1;
+    }
+    return delay;
+}
+
+int QDropbox::jitter(const int& bound) {
+    // xorshift, the application's qrand() sequence is left alone
+    m_jitterState ^= m_jitterState << 13;
+    m_jitterState ^= m_jitterState >> 17;
+    m_jitterState ^= m_jitterState << 5;
+    return (int) (m_jitterState % (quint32) bound);
+}
+
+void QDropbox::settle(QDropboxRequest* request, QNetworkReply* reply) {
+    if (request->isCancelled()) {
+        request->reject(QNetworkReply::OperationCanceledError, "Request cancelled");
+    } else if (request->isTimedOut()) {
+        request->reject(QNetworkReply::TimeoutError, "Request timed out");
+    } else if (reply->error() != QNetworkReply::NoError) {
+        request->reject(reply->error(), reply->errorString());
+    } else {
+        // settled before finished() whether or not anybody waits yet, the handler reads the body afterwards
+        QByteArray data = reply->rawHeader("Dropbox-API-Result");
+        if (data.isEmpty()) {
+            data = reply->peek(reply->bytesAvailable());
+        }
+        bool res = false;
+        QVariant value = QJson::Parser().parse(data, &res);
+        request->resolve(res ? value : QVariant());
+    }
+}
+
+QDropboxRequest* QDropbox::coalesce(const QString& key) {
+    // identical calls of different accounts are different calls
+    QString accountKey = token().append("|").append(key);
+    if (!m_coalesceRequests || !m_inflight.contains(accountKey)) {
+        return 0;
+    }
+
+    // every caller gets a handle of its own, settled with the result of the call it joined;
+    // only the first caller's handle carries the reply, cancelling it cancels the call for all of them
+    QDropboxRequest* request = m_inflight.value(accountKey);
+    QDropboxRequest* joined = new QDropboxRequest(request->getRequest(), request->getData(), 0, this);
+    joined->setNamespace(request->getNamespace());
+    joined->getContext() = request->getContext();
+    joined->getContext().joined.clear();
+    joined->getContext().coalesceKey = accountKey;
+    request->getContext().joined.append(joined);
+
+    bool res = QObject::connect(joined, SIGNAL(cancelled()), this, SLOT(onRequestCancelled()));
+    Q_ASSERT(res);
+    Q_UNUSED(res);
+    return joined;
+}
+
+void QDropbox::registerInflight(const QString& key, QDropboxRequest* request) {
+    QString accountKey = token().append("|").append(key);
+    request->getContext().coalesceKey = accountKey;
+    if (m_coalesceRequests) {
+        m_inflight.insert(accountKey, request);
+    }
+}
+
+void QDropbox::unregisterInflight(QNetworkReply* reply) {
+    const QDropboxRequestContext& ctx = context();
+    QDropboxRequest* request = m_inflight.value(ctx.coalesceKey, 0);
+    if (request != 0 && request->getReply() == reply) {
+        m_inflight.remove(ctx.coalesceKey);
+    }
+}
+
+void QDropbox::settleJoined(QDropboxRequest* request) {
+    QList<QDropboxRequest*> joined = request->getContext().joined;
+    request->getContext().joined.clear();
+    foreach(QDropboxRequest* caller, joined) {
+        const QDropboxResult& result = request->getResult();
+        if (caller->isCancelled()) {
+            caller->reject(QNetworkReply::OperationCanceledError, "Request cancelled");
+        } else if (result.isOk()) {
+            caller->resolve(result.value);
+        } else {
+            caller->reject(result.error, result.errorString);
+        }
+        caller->finish();
+        caller->deleteLater();
+    }
 }
 
-QNetworkReply* QDropbox::moveFile(const QString& fromPath, const QString& toPath, const bool& allowSharedFolder, const bool& autorename, const bool& allowOwnershipTransfer) {
+QDropboxRequest* QDropbox::moveFile(const QString& fromPath, const QString& toPath, const char* slot, const bool& allowSharedFolder, const bool& autorename, const bool& allowOwnershipTransfer) {
     QNetworkRequest req = prepareRequest("/files/move_v2");
     QVariantMap map;
     map["from_path"] = fromPath;
@@ -1486,7 +3086,9 @@ QNetworkReply* QDropbox::moveFile(const QString& fromPath, const QString& toPath
     map["allow_ownership_transfer"] = allowOwnershipTransfer;
 
     QJson::Serializer serializer;
-    return m_network.post(req, serializer.serialize(map));
+    QDropboxRequest* request = send(req, serializer.serialize(map), slot);
+    request->setIdempotent(false);
+    return request;
 }
 
 void QDropbox::processUploadsQueue() {
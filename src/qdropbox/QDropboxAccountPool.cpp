@@ -0,0 +1,58 @@
+/*
+ * QDropboxAccountPool.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#include "../../include/qdropbox/QDropboxAccountPool.hpp"
+
+Logger QDropboxAccountPool::logger = Logger::getLogger("QDropboxAccountPool");
+
+QDropboxAccountPool::QDropboxAccountPool(QObject* parent) : QObject(parent), m_pDropbox(new QDropbox(this)) {
+    init();
+}
+
+QDropboxAccountPool::QDropboxAccountPool(QDropbox* dropbox, QObject* parent) : QObject(parent), m_pDropbox(dropbox) {
+    init();
+}
+
+QDropboxAccountPool::~QDropboxAccountPool() {}
+
+QDropbox* QDropboxAccountPool::getDropbox() const { return m_pDropbox; }
+
+QDropboxAccountPool& QDropboxAccountPool::addAccount(const QString& accountId, const QString& accessToken) {
+    m_tokens.insert(accountId, accessToken);
+    return *this;
+}
+
+QDropboxAccountPool& QDropboxAccountPool::removeAccount(const QString& accountId) {
+    m_tokens.remove(accountId);
+    return *this;
+}
+
+bool QDropboxAccountPool::hasAccount(const QString& accountId) const {
+    return m_tokens.contains(accountId);
+}
+
+QStringList QDropboxAccountPool::getAccounts() const {
+    return m_tokens.keys();
+}
+
+int QDropboxAccountPool::size() const {
+    return m_tokens.size();
+}
+
+QDropbox* QDropboxAccountPool::account(const QString& accountId) {
+    if (!m_tokens.contains(accountId)) {
+        // calls still go out and fail as unauthorized, instead of running on the previous account
+        logger.warn("Unknown account: " + accountId);
+    }
+    m_pDropbox->setAccessToken(m_tokens.value(accountId, ""));
+    return m_pDropbox;
+}
+
+void QDropboxAccountPool::init() {
+    m_pDropbox->setWriteCombining(false);
+    m_pDropbox->setThumbnailCache(0);
+}
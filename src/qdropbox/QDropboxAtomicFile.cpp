@@ -0,0 +1,50 @@
+/*
+ * QDropboxAtomicFile.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#include "../../include/qdropbox/QDropboxAtomicFile.hpp"
+#include <QFile>
+
+#ifdef Q_OS_UNIX
+#include <stdio.h>
+#include <unistd.h>
+#endif
+
+#define TMP_SUFFIX ".tmp"
+
+bool QDropboxAtomicFile::save(const QString& path, const QByteArray& data) {
+    QFile file(path + TMP_SUFFIX);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    if (file.write(data) != data.size() || !file.flush()) {
+        file.close();
+        file.remove();
+        return false;
+    }
+
+#ifdef Q_OS_UNIX
+    // on disk before it takes the place of the old file, rename(2) replaces it in one step
+    ::fsync(file.handle());
+    file.close();
+    return ::rename(QFile::encodeName(file.fileName()).constData(), QFile::encodeName(path).constData()) == 0;
+#else
+    file.close();
+    QFile::remove(path);
+    return file.rename(path);
+#endif
+}
+
+void QDropboxAtomicFile::recover(const QString& path) {
+#ifndef Q_OS_UNIX
+    // the old file is removed before the new one is renamed, a complete new one may be left behind
+    if (!QFile::exists(path) && QFile::exists(path + TMP_SUFFIX)) {
+        QFile::rename(path + TMP_SUFFIX, path);
+    }
+#else
+    Q_UNUSED(path);
+#endif
+}
@@ -0,0 +1,92 @@
+/*
+ * QDropboxBlockCopy.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#include "../../include/qdropbox/QDropboxBlockCopy.hpp"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+#ifdef Q_OS_LINUX
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+#endif
+
+QDropboxBlockCopy::QDropboxBlockCopy(const QString& contentHash, const QString& source, const QString& localPath, const bool& hardLinks, QObject* parent) : QObject(parent),
+        m_contentHash(contentHash), m_source(source), m_localPath(localPath), m_target(QFileInfo(localPath).absoluteFilePath()), m_hardLinks(hardLinks) {
+    setAutoDelete(false);
+}
+
+QDropboxBlockCopy::~QDropboxBlockCopy() {}
+
+void QDropboxBlockCopy::run() {
+    if (m_source.compare(m_target) != 0) {
+        QFileInfo info(m_target);
+        if (!info.absoluteDir().exists()) {
+            info.absoluteDir().mkpath(info.absolutePath());
+        }
+
+        // same as downloads, the target only appears once it is complete
+        QString part = m_target + ".part";
+        QFile::remove(part);
+        if (!link(m_source, part) && !QFile::copy(m_source, part)) {
+            m_errorString = "Cannot copy " + m_source + " to " + part;
+            QFile::remove(part);
+        } else {
+            QFile::remove(m_target);
+            if (!QFile::rename(part, m_target)) {
+                m_errorString = "Cannot rename " + part + " to " + m_target;
+                QFile::remove(part);
+            }
+        }
+    }
+
+    emit copied();
+}
+
+const QString& QDropboxBlockCopy::getContentHash() const { return m_contentHash; }
+
+const QString& QDropboxBlockCopy::getSource() const { return m_source; }
+
+const QString& QDropboxBlockCopy::getLocalPath() const { return m_localPath; }
+
+const QString& QDropboxBlockCopy::getTarget() const { return m_target; }
+
+bool QDropboxBlockCopy::isCopied() const { return m_errorString.isEmpty(); }
+
+const QString& QDropboxBlockCopy::getErrorString() const { return m_errorString; }
+
+bool QDropboxBlockCopy::link(const QString& source, const QString& target) const {
+#if defined(Q_OS_LINUX) && defined(FICLONE)
+    // a reflink shares the data copy on write, both files stay independent
+    int in = ::open(QFile::encodeName(source).constData(), O_RDONLY);
+    if (in >= 0) {
+        int out = ::open(QFile::encodeName(target).constData(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        bool cloned = out >= 0 && ::ioctl(out, FICLONE, in) == 0;
+        if (out >= 0) {
+            ::close(out);
+        }
+        ::close(in);
+        if (cloned) {
+            return true;
+        }
+        QFile::remove(target);
+    }
+#endif
+#ifdef Q_OS_UNIX
+    // a hard link shares the file itself, writing to one copy changes all of them
+    if (m_hardLinks && ::link(QFile::encodeName(source).constData(), QFile::encodeName(target).constData()) == 0) {
+        return true;
+    }
+#endif
+    Q_UNUSED(source);
+    Q_UNUSED(target);
+    return false;
+}
@@ -0,0 +1,191 @@
+/*
+ * QDropboxBlockStore.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#include "../../include/qdropbox/QDropboxBlockStore.hpp"
+#include "../../include/qdropbox/QDropboxAtomicFile.hpp"
+#include "../../include/qdropbox/QDropboxBlockCopy.hpp"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDataStream>
+#include <QThreadPool>
+
+Logger QDropboxBlockStore::logger = Logger::getLogger("QDropboxBlockStore");
+
+#define INDEX_VERSION 1
+#define SAVE_DELAY 2000
+
+QDropboxBlockStore::QDropboxBlockStore(const QString& indexPath, QObject* parent) : QObject(parent),
+        m_indexPath(indexPath), m_hardLinks(false) {
+    m_saveTimer.setSingleShot(true);
+
+    bool res = QObject::connect(&m_saveTimer, SIGNAL(timeout()), this, SLOT(save()));
+    Q_ASSERT(res);
+    Q_UNUSED(res);
+
+    QFileInfo info(m_indexPath);
+    if (!info.absoluteDir().exists()) {
+        info.absoluteDir().mkpath(info.absolutePath());
+    }
+    load();
+}
+
+QDropboxBlockStore::~QDropboxBlockStore() {
+    if (m_saveTimer.isActive()) {
+        save();
+    }
+}
+
+const QString& QDropboxBlockStore::getIndexPath() const { return m_indexPath; }
+
+const bool& QDropboxBlockStore::isHardLinks() const { return m_hardLinks; }
+QDropboxBlockStore& QDropboxBlockStore::setHardLinks(const bool& hardLinks) {
+    m_hardLinks = hardLinks;
+    return *this;
+}
+
+QString QDropboxBlockStore::find(const QString& contentHash) {
+    if (contentHash.isEmpty() || !m_blocks.contains(contentHash)) {
+        return "";
+    }
+
+    QList<Block>& blocks = m_blocks[contentHash];
+    while (!blocks.isEmpty()) {
+        const Block& block = blocks.first();
+        QFileInfo info(block.path);
+        if (info.isFile() && info.size() == block.size && info.lastModified().toMSecsSinceEpoch() == block.modified) {
+            return block.path;
+        }
+
+        // changed or gone since it was indexed, its content_hash is unknown now
+        m_hashes.remove(block.path);
+        blocks.removeFirst();
+        scheduleSave();
+    }
+    m_blocks.remove(contentHash);
+    return "";
+}
+
+bool QDropboxBlockStore::materialize(const QString& contentHash, const QString& localPath) {
+    QString source = find(contentHash);
+    if (source.isEmpty()) {
+        return false;
+    }
+
+    // a plain copy of a large file takes a while, it is done on a pool thread and reported by materialized()
+    QDropboxBlockCopy* copy = new QDropboxBlockCopy(contentHash, source, localPath, m_hardLinks);
+    bool res = QObject::connect(copy, SIGNAL(copied()), this, SLOT(onCopied()));
+    Q_ASSERT(res);
+    Q_UNUSED(res);
+    QThreadPool::globalInstance()->start(copy);
+    return true;
+}
+
+void QDropboxBlockStore::onCopied() {
+    QDropboxBlockCopy* copy = qobject_cast<QDropboxBlockCopy*>(QObject::sender());
+    if (copy->isCopied()) {
+        logger.debug("Materialized " + copy->getTarget() + " from " + copy->getSource());
+        insert(copy->getContentHash(), copy->getTarget());
+    } else {
+        logger.warn(copy->getErrorString());
+    }
+    emit materialized(copy->getLocalPath(), copy->isCopied());
+    copy->deleteLater();
+}
+
+void QDropboxBlockStore::insert(const QString& contentHash, const QString& localPath) {
+    QFileInfo info(localPath);
+    remove(info.absoluteFilePath());
+    if (contentHash.isEmpty() || !info.isFile()) {
+        return;
+    }
+
+    Block block;
+    block.path = info.absoluteFilePath();
+    block.size = info.size();
+    block.modified = info.lastModified().toMSecsSinceEpoch();
+    m_blocks[contentHash].append(block);
+    m_hashes.insert(block.path, contentHash);
+    scheduleSave();
+}
+
+void QDropboxBlockStore::remove(const QString& localPath) {
+    QString path = QFileInfo(localPath).absoluteFilePath();
+    QString contentHash = m_hashes.take(path);
+    if (contentHash.isEmpty()) {
+        return;
+    }
+
+    QList<Block>& blocks = m_blocks[contentHash];
+    for (int i = blocks.size() - 1; i >= 0; i--) {
+        if (blocks.at(i).path.compare(path) == 0) {
+            blocks.removeAt(i);
+        }
+    }
+    if (blocks.isEmpty()) {
+        m_blocks.remove(contentHash);
+    }
+    scheduleSave();
+}
+
+void QDropboxBlockStore::clear() {
+    m_blocks.clear();
+    m_hashes.clear();
+    scheduleSave();
+}
+
+void QDropboxBlockStore::save() {
+    m_saveTimer.stop();
+
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out << (qint32) INDEX_VERSION << (qint32) m_hashes.size();
+    QHash<QString, QList<Block> >::const_iterator it = m_blocks.constBegin();
+    for (; it != m_blocks.constEnd(); ++it) {
+        foreach(Block block, it.value()) {
+            out << it.key() << block.path << block.size << block.modified;
+        }
+    }
+
+    if (!QDropboxAtomicFile::save(m_indexPath, data)) {
+        logger.error("Cannot save block index: " + m_indexPath);
+    }
+}
+
+void QDropboxBlockStore::load() {
+    QDropboxAtomicFile::recover(m_indexPath);
+
+    QFile file(m_indexPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream in(&file);
+    qint32 version = 0;
+    qint32 count = 0;
+    in >> version >> count;
+    if (version != INDEX_VERSION) {
+        logger.warn("Unknown block index version: " + QString::number(version));
+        return;
+    }
+
+    for (int i = 0; i < count && !in.atEnd(); i++) {
+        QString contentHash;
+        Block block;
+        in >> contentHash >> block.path >> block.size >> block.modified;
+        m_blocks[contentHash].append(block);
+        m_hashes.insert(block.path, contentHash);
+    }
+    file.close();
+}
+
+void QDropboxBlockStore::scheduleSave() {
+    if (!m_saveTimer.isActive()) {
+        m_saveTimer.start(SAVE_DELAY);
+    }
+}
@@ -0,0 +1,165 @@
+/*
+ * QDropboxConcurrentClient.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#include "../../include/qdropbox/QDropboxConcurrentClient.hpp"
+#include <QMetaObject>
+#include <QMetaType>
+#include <QMutexLocker>
+
+Logger QDropboxConcurrentClient::logger = Logger::getLogger("QDropboxConcurrentClient");
+
+QDropboxConcurrentClient::QDropboxConcurrentClient(const QString& accessToken, const int& threads, QObject* parent) : QObject(parent), m_next(0) {
+    qRegisterMetaType<QDropboxFile*>("QDropboxFile*");
+    qRegisterMetaType<QList<QDropboxFile*> >("QList<QDropboxFile*>");
+    qRegisterMetaType<QDropboxTempLink*>("QDropboxTempLink*");
+    qRegisterMetaType<QImage*>("QImage*");
+    qRegisterMetaType<QNetworkReply::NetworkError>("QNetworkReply::NetworkError");
+
+    m_configuration["accessToken"] = accessToken;
+
+    int count = qMax(1, threads);
+    for (int i = 0; i < count; i++) {
+        QThread* thread = new QThread(this);
+        QDropboxWorker* worker = new QDropboxWorker();
+        worker->moveToThread(thread);
+        thread->start();
+
+        QMetaObject::invokeMethod(worker, "start", Qt::BlockingQueuedConnection, Q_ARG(QVariantMap, m_configuration));
+        connectWorker(worker);
+
+        m_threads.append(thread);
+        m_workers.append(worker);
+    }
+    logger.info("Started workers: " + QString::number(count));
+}
+
+QDropboxConcurrentClient::~QDropboxConcurrentClient() {
+    for (int i = 0; i < m_workers.size(); i++) {
+        QDropboxWorker* worker = m_workers.at(i);
+        QThread* thread = m_threads.at(i);
+
+        QMetaObject::invokeMethod(worker, "stop", Qt::BlockingQueuedConnection);
+        thread->quit();
+        thread->wait();
+        delete worker;
+    }
+}
+
+int QDropboxConcurrentClient::size() const {
+    return m_workers.size();
+}
+
+QString QDropboxConcurrentClient::getAccessToken() const {
+    QMutexLocker locker(&m_mutex);
+    return m_configuration.value("accessToken").toString();
+}
+
+QDropboxConcurrentClient& QDropboxConcurrentClient::setAccessToken(const QString& accessToken) {
+    QVariantMap configuration;
+    configuration["accessToken"] = accessToken;
+    return configure(configuration);
+}
+
+QVariantMap QDropboxConcurrentClient::getConfiguration() const {
+    QMutexLocker locker(&m_mutex);
+    return m_configuration;
+}
+
+QDropboxConcurrentClient& QDropboxConcurrentClient::configure(const QVariantMap& configuration) {
+    QMutexLocker locker(&m_mutex);
+    foreach(QString key, configuration.keys()) {
+        m_configuration[key] = configuration.value(key);
+    }
+    foreach(QDropboxWorker* worker, m_workers) {
+        QMetaObject::invokeMethod(worker, "configure", Qt::QueuedConnection, Q_ARG(QVariantMap, configuration));
+    }
+    return *this;
+}
+
+void QDropboxConcurrentClient::getMetadata(const QString& path, const bool& includeMediaInfo) {
+    QMetaObject::invokeMethod(next(), "getMetadata", Qt::QueuedConnection, Q_ARG(QString, path), Q_ARG(bool, includeMediaInfo));
+}
+
+void QDropboxConcurrentClient::listFolder(const QString& path, const bool& includeMediaInfo, const bool& recursive) {
+    QMetaObject::invokeMethod(next(), "listFolder", Qt::QueuedConnection, Q_ARG(QString, path), Q_ARG(bool, includeMediaInfo), Q_ARG(bool, recursive));
+}
+
+void QDropboxConcurrentClient::listFolderContinue(const QString& cursor) {
+    QMetaObject::invokeMethod(next(), "listFolderContinue", Qt::QueuedConnection, Q_ARG(QString, cursor));
+}
+
+void QDropboxConcurrentClient::getThumbnail(const QString& path, const QString& size, const QString& format) {
+    QMetaObject::invokeMethod(next(), "getThumbnail", Qt::QueuedConnection, Q_ARG(QString, path), Q_ARG(QString, size), Q_ARG(QString, format));
+}
+
+void QDropboxConcurrentClient::getTemporaryLink(const QString& path) {
+    QMetaObject::invokeMethod(next(), "getTemporaryLink", Qt::QueuedConnection, Q_ARG(QString, path));
+}
+
+void QDropboxConcurrentClient::download(const QString& path, const QString& rev) {
+    QMetaObject::invokeMethod(next(), "download", Qt::QueuedConnection, Q_ARG(QString, path), Q_ARG(QString, rev));
+}
+
+void QDropboxConcurrentClient::upload(const QString& localPath, const QString& remotePath, const QString& mode) {
+    QMetaObject::invokeMethod(next(), "upload", Qt::QueuedConnection, Q_ARG(QString, localPath), Q_ARG(QString, remotePath), Q_ARG(QString, mode));
+}
+
+void QDropboxConcurrentClient::createFolder(const QString& path, const bool& autorename) {
+    QMetaObject::invokeMethod(next(), "createFolder", Qt::QueuedConnection, Q_ARG(QString, path), Q_ARG(bool, autorename));
+}
+
+void QDropboxConcurrentClient::deleteFile(const QString& path) {
+    QMetaObject::invokeMethod(next(), "deleteFile", Qt::QueuedConnection, Q_ARG(QString, path));
+}
+
+void QDropboxConcurrentClient::move(const QString& fromPath, const QString& toPath) {
+    QMetaObject::invokeMethod(next(), "move", Qt::QueuedConnection, Q_ARG(QString, fromPath), Q_ARG(QString, toPath));
+}
+
+void QDropboxConcurrentClient::copy(const QString& fromPath, const QString& toPath) {
+    QMetaObject::invokeMethod(next(), "copy", Qt::QueuedConnection, Q_ARG(QString, fromPath), Q_ARG(QString, toPath));
+}
+
+QDropboxWorker* QDropboxConcurrentClient::next() {
+    // the worker list never changes after construction, only the counter is shared
+    uint n = (uint) m_next.fetchAndAddRelaxed(1);
+    return m_workers.at(n % (uint) m_workers.size());
+}
+
+void QDropboxConcurrentClient::connectWorker(QDropboxWorker* worker) {
+    QDropbox* dropbox = worker->getDropbox();
+
+    bool res = QObject::connect(worker, SIGNAL(listFolderLoaded(const QString&, const QList<QDropboxFile*>&, const QString&, const bool&)),
+            this, SIGNAL(listFolderLoaded(const QString&, const QList<QDropboxFile*>&, const QString&, const bool&)));
+    Q_ASSERT(res);
+    res = QObject::connect(worker, SIGNAL(listFolderContinueLoaded(const QList<QDropboxFile*>&, const QString&, const QString&, const bool&)),
+            this, SIGNAL(listFolderContinueLoaded(const QList<QDropboxFile*>&, const QString&, const QString&, const bool&)));
+    Q_ASSERT(res);
+    res = QObject::connect(dropbox, SIGNAL(metadataReceived(QDropboxFile*)), this, SIGNAL(metadataReceived(QDropboxFile*)));
+    Q_ASSERT(res);
+    res = QObject::connect(dropbox, SIGNAL(thumbnailLoaded(const QString&, const QString&, QImage*)), this, SIGNAL(thumbnailLoaded(const QString&, const QString&, QImage*)));
+    Q_ASSERT(res);
+    res = QObject::connect(dropbox, SIGNAL(temporaryLinkLoaded(QDropboxTempLink*)), this, SIGNAL(temporaryLinkLoaded(QDropboxTempLink*)));
+    Q_ASSERT(res);
+    res = QObject::connect(dropbox, SIGNAL(downloaded(const QString&, const QString&)), this, SIGNAL(downloaded(const QString&, const QString&)));
+    Q_ASSERT(res);
+    res = QObject::connect(dropbox, SIGNAL(uploaded(QDropboxFile*)), this, SIGNAL(uploaded(QDropboxFile*)));
+    Q_ASSERT(res);
+    res = QObject::connect(dropbox, SIGNAL(uploadFailed(const QString&)), this, SIGNAL(uploadFailed(const QString&)));
+    Q_ASSERT(res);
+    res = QObject::connect(dropbox, SIGNAL(folderCreated(QDropboxFile*)), this, SIGNAL(folderCreated(QDropboxFile*)));
+    Q_ASSERT(res);
+    res = QObject::connect(dropbox, SIGNAL(fileDeleted(QDropboxFile*)), this, SIGNAL(fileDeleted(QDropboxFile*)));
+    Q_ASSERT(res);
+    res = QObject::connect(dropbox, SIGNAL(moved(QDropboxFile*, const QString&, const QString&)), this, SIGNAL(moved(QDropboxFile*, const QString&, const QString&)));
+    Q_ASSERT(res);
+    res = QObject::connect(dropbox, SIGNAL(copied(QDropboxFile*, const QString&, const QString&)), this, SIGNAL(copied(QDropboxFile*, const QString&, const QString&)));
+    Q_ASSERT(res);
+    res = QObject::connect(dropbox, SIGNAL(error(QNetworkReply::NetworkError, const QString&)), this, SIGNAL(error(QNetworkReply::NetworkError, const QString&)));
+    Q_ASSERT(res);
+    Q_UNUSED(res);
+}
@@ -0,0 +1,200 @@
+/*
+ * QDropboxContentHash.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#include "../../include/qdropbox/QDropboxContentHash.hpp"
+#include <QFile>
+#include <QtGlobal>
+#if QT_VERSION >= 0x050000
+#include <QCryptographicHash>
+#else
+#include <string.h>
+#endif
+
+#define BLOCK_SIZE 4194304 // 4 MB
+#define READ_SIZE 262144
+
+#if QT_VERSION >= 0x050000
+
+class QDropboxSha256 {
+public:
+    QDropboxSha256() : m_hash(QCryptographicHash::Sha256) {}
+
+    void reset() { m_hash.reset(); }
+    void update(const char* data, const int& size) { m_hash.addData(data, size); }
+    QByteArray digest() { return m_hash.result(); }
+
+private:
+    QCryptographicHash m_hash;
+};
+
+#else
+
+// QCryptographicHash has no SHA-256 before Qt 5
+static const quint32 SHA256_K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#define ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+class QDropboxSha256 {
+public:
+    QDropboxSha256() { reset(); }
+
+    void reset() {
+        m_state[0] = 0x6a09e667;
+        m_state[1] = 0xbb67ae85;
+        m_state[2] = 0x3c6ef372;
+        m_state[3] = 0xa54ff53a;
+        m_state[4] = 0x510e527f;
+        m_state[5] = 0x9b05688c;
+        m_state[6] = 0x1f83d9ab;
+        m_state[7] = 0x5be0cd19;
+        m_length = 0;
+        m_buffered = 0;
+    }
+
+    void update(const char* data, const int& size) {
+        const uchar* p = reinterpret_cast<const uchar*>(data);
+        int left = size;
+        m_length += size;
+        while (left > 0) {
+            int n = qMin(64 - m_buffered, left);
+            memcpy(m_buffer + m_buffered, p, n);
+            m_buffered += n;
+            p += n;
+            left -= n;
+            if (m_buffered == 64) {
+                transform(m_buffer);
+                m_buffered = 0;
+            }
+        }
+    }
+
+    QByteArray digest() {
+        quint64 bits = m_length * 8;
+        uchar padding[72];
+        memset(padding, 0, sizeof(padding));
+        padding[0] = 0x80;
+        int padSize = m_buffered < 56 ? 56 - m_buffered : 120 - m_buffered;
+        for (int i = 0; i < 8; i++) {
+            padding[padSize + i] = (uchar) (bits >> (56 - 8 * i));
+        }
+        update(reinterpret_cast<const char*>(padding), padSize + 8);
+
+        QByteArray result(32, 0);
+        for (int i = 0; i < 8; i++) {
+            result[i * 4] = (char) (m_state[i] >> 24);
+            result[i * 4 + 1] = (char) (m_state[i] >> 16);
+            result[i * 4 + 2] = (char) (m_state[i] >> 8);
+            result[i * 4 + 3] = (char) m_state[i];
+        }
+        return result;
+    }
+
+private:
+    quint32 m_state[8];
+    quint64 m_length;
+    uchar m_buffer[64];
+    int m_buffered;
+
+    void transform(const uchar* block) {
+        quint32 w[64];
+        for (int i = 0; i < 16; i++) {
+            w[i] = ((quint32) block[i * 4] << 24) | ((quint32) block[i * 4 + 1] << 16) | ((quint32) block[i * 4 + 2] << 8) | (quint32) block[i * 4 + 3];
+        }
+        for (int i = 16; i < 64; i++) {
+            quint32 s0 = ROTR(w[i - 15], 7) ^ ROTR(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            quint32 s1 = ROTR(w[i - 2], 17) ^ ROTR(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        quint32 a = m_state[0], b = m_state[1], c = m_state[2], d = m_state[3];
+        quint32 e = m_state[4], f = m_state[5], g = m_state[6], h = m_state[7];
+        for (int i = 0; i < 64; i++) {
+            quint32 t1 = h + (ROTR(e, 6) ^ ROTR(e, 11) ^ ROTR(e, 25)) + ((e & f) ^ (~e & g)) + SHA256_K[i] + w[i];
+            quint32 t2 = (ROTR(a, 2) ^ ROTR(a, 13) ^ ROTR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        m_state[0] += a;
+        m_state[1] += b;
+        m_state[2] += c;
+        m_state[3] += d;
+        m_state[4] += e;
+        m_state[5] += f;
+        m_state[6] += g;
+        m_state[7] += h;
+    }
+};
+
+#endif
+
+QDropboxContentHash::QDropboxContentHash() : m_pBlock(new QDropboxSha256()), m_blockSize(0) {}
+
+QDropboxContentHash::~QDropboxContentHash() {
+    delete m_pBlock;
+}
+
+void QDropboxContentHash::addData(const char* data, const int& size) {
+    int offset = 0;
+    while (offset < size) {
+        int n = (int) qMin((qint64) (size - offset), BLOCK_SIZE - m_blockSize);
+        m_pBlock->update(data + offset, n);
+        m_blockSize += n;
+        offset += n;
+        if (m_blockSize == BLOCK_SIZE) {
+            m_digests.append(m_pBlock->digest());
+            m_pBlock->reset();
+            m_blockSize = 0;
+        }
+    }
+}
+
+void QDropboxContentHash::addData(const QByteArray& data) {
+    addData(data.constData(), data.size());
+}
+
+QString QDropboxContentHash::result() {
+    if (m_blockSize > 0) {
+        m_digests.append(m_pBlock->digest());
+        m_pBlock->reset();
+        m_blockSize = 0;
+    }
+
+    QDropboxSha256 overall;
+    overall.update(m_digests.constData(), m_digests.size());
+    return QString(overall.digest().toHex());
+}
+
+QString QDropboxContentHash::file(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return "";
+    }
+
+    QDropboxContentHash hash;
+    QByteArray buffer(READ_SIZE, 0);
+    qint64 read = 0;
+    while ((read = file.read(buffer.data(), READ_SIZE)) > 0) {
+        hash.addData(buffer.constData(), (int) read);
+    }
+    file.close();
+    return read < 0 ? QString("") : hash.result();
+}
@@ -0,0 +1,237 @@
+/*
+ * QDropboxDeltaSync.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#include "../../include/qdropbox/QDropboxDeltaSync.hpp"
+#include "../../include/qdropbox/QDropboxCommon.hpp"
+
+Logger QDropboxDeltaSync::logger = Logger::getLogger("QDropboxDeltaSync");
+
+#define LONGPOLL_TIMEOUT 480 // max allowed by Dropbox
+#define RETRY_DELAY 1000
+#define MAX_RETRY_DELAY 60000
+
+QDropboxDeltaSync::QDropboxDeltaSync(QDropbox* dropbox, QObject* parent) : QObject(parent),
+        m_pDropbox(dropbox), m_path(""), m_recursive(true), m_cursor(""), m_timeout(LONGPOLL_TIMEOUT),
+        m_state(Idle), m_resumeState(Idle), m_retryDelay(RETRY_DELAY), m_pRequest(0) {
+    m_timer.setSingleShot(true);
+
+    bool res = QObject::connect(&m_timer, SIGNAL(timeout()), this, SLOT(resume()));
+    Q_ASSERT(res);
+    res = QObject::connect(m_pDropbox, SIGNAL(listFolderLoaded(const QString&, QList<QDropboxFile*>&, const QString&, const bool&)),
+            this, SLOT(onListFolderLoaded(const QString&, QList<QDropboxFile*>&, const QString&, const bool&)));
+    Q_ASSERT(res);
+    res = QObject::connect(m_pDropbox, SIGNAL(listFolderContinueLoaded(QList<QDropboxFile*>&, const QString&, const QString&, const bool&)),
+            this, SLOT(onListFolderContinueLoaded(QList<QDropboxFile*>&, const QString&, const QString&, const bool&)));
+    Q_ASSERT(res);
+    res = QObject::connect(m_pDropbox, SIGNAL(listFolderLongPollFinished(const QString&, const bool&, const int&)),
+            this, SLOT(onListFolderLongPollFinished(const QString&, const bool&, const int&)));
+    Q_ASSERT(res);
+    Q_UNUSED(res);
+}
+
+QDropboxDeltaSync::~QDropboxDeltaSync() {}
+
+const QString& QDropboxDeltaSync::getPath() const { return m_path; }
+
+const bool& QDropboxDeltaSync::isRecursive() const { return m_recursive; }
+
+const QString& QDropboxDeltaSync::getCursor() const { return m_cursor; }
+QDropboxDeltaSync& QDropboxDeltaSync::setCursor(const QString& cursor) {
+    m_cursor = cursor;
+    return *this;
+}
+
+const int& QDropboxDeltaSync::getTimeout() const { return m_timeout; }
+QDropboxDeltaSync& QDropboxDeltaSync::setTimeout(const int& timeout) {
+    m_timeout = timeout;
+    return *this;
+}
+
+bool QDropboxDeltaSync::isRunning() const {
+    return m_state != Idle;
+}
+
+void QDropboxDeltaSync::start(const QString& path, const bool& recursive) {
+    m_path = path;
+    m_recursive = recursive;
+    m_retryDelay = RETRY_DELAY;
+
+    if (m_cursor.isEmpty()) {
+        m_state = Listing;
+        track(m_pDropbox->listFolder(m_path, false, m_recursive));
+    } else {
+        poll();
+    }
+}
+
+void QDropboxDeltaSync::stop() {
+    m_timer.stop();
+    m_state = Idle;
+    if (m_pRequest != 0) {
+        QDropboxRequest* request = m_pRequest;
+        m_pRequest = 0;
+        request->cancel();
+    }
+}
+
+void QDropboxDeltaSync::onListFolderLoaded(const QString& path, QList<QDropboxFile*>& files, const QString& cursor, const bool& hasMore) {
+    if (m_state != Listing || path.compare(m_path) != 0) {
+        return;
+    }
+    processPage(files, cursor, hasMore);
+}
+
+void QDropboxDeltaSync::onListFolderContinueLoaded(QList<QDropboxFile*>& files, const QString& prevCursor, const QString& cursor, const bool& hasMore) {
+    if (m_state != Continuing || prevCursor.compare(m_cursor) != 0) {
+        return;
+    }
+    processPage(files, cursor, hasMore);
+}
+
+void QDropboxDeltaSync::onListFolderLongPollFinished(const QString& cursor, const bool& changes, const int& backoff) {
+    if (m_state != Polling || cursor.compare(m_cursor) != 0) {
+        return;
+    }
+
+    m_retryDelay = RETRY_DELAY;
+    if (backoff > 0) {
+        m_backoffUntil = QDateTime::currentDateTime().addSecs(backoff);
+    }
+
+    if (changes) {
+        m_state = Continuing;
+        track(m_pDropbox->listFolderContinue(m_cursor));
+    } else {
+        poll();
+    }
+}
+
+void QDropboxDeltaSync::onRequestFailed(QNetworkReply::NetworkError e, const QString& errorString) {
+    QDropboxRequest* request = qobject_cast<QDropboxRequest*>(QObject::sender());
+    if (request == 0 || request != m_pRequest || m_state == Idle || m_state == Waiting) {
+        return;
+    }
+    m_pRequest = 0;
+
+    if (request->isCancelled()) {
+        logger.info("Request cancelled, sync stopped: " + m_path);
+        stop();
+        return;
+    }
+
+    logger.warn("Request failed, retry in " + QString::number(m_retryDelay) + " ms: " + errorString);
+    wait(m_retryDelay, m_state);
+    m_retryDelay = qMin(m_retryDelay * 2, MAX_RETRY_DELAY);
+    Q_UNUSED(e);
+}
+
+void QDropboxDeltaSync::onRequestFinished() {
+    // failed() follows finished(), the handle is only forgotten once that had its chance to run
+    QDropboxRequest* request = qobject_cast<QDropboxRequest*>(QObject::sender());
+    if (request != 0 && request == m_pRequest && request->getResult().isOk()) {
+        m_pRequest = 0;
+    }
+}
+
+void QDropboxDeltaSync::resume() {
+    switch (m_resumeState) {
+        case Listing:
+            m_state = Listing;
+            track(m_pDropbox->listFolder(m_path, false, m_recursive));
+            break;
+        case Continuing:
+            m_state = Continuing;
+            track(m_pDropbox->listFolderContinue(m_cursor));
+            break;
+        case Polling:
+            poll();
+            break;
+        default:
+            break;
+    }
+}
+
+void QDropboxDeltaSync::processPage(QList<QDropboxFile*>& files, const QString& cursor, const bool& hasMore) {
+    QList<QDropboxFile*> addedFiles;
+    QList<QDropboxFile*> modifiedFiles;
+    QStringList deletedPaths;
+
+    foreach(QDropboxFile* file, files) {
+        QString pathLower = file->getPathLower();
+        if (file->getTag().compare(DELETED_TAG) == 0) {
+            deletedPaths.append(pathLower);
+            m_revs.remove(pathLower);
+            QString prefix = pathLower + "/";
+            QMutableHashIterator<QString, QString> it(m_revs);
+            while (it.hasNext()) {
+                if (it.next().key().startsWith(prefix)) {
+                    it.remove();
+                }
+            }
+        } else if (!m_revs.contains(pathLower)) {
+            m_revs.insert(pathLower, file->getRev());
+            addedFiles.append(file);
+        } else if (file->isFile() && m_revs.value(pathLower).compare(file->getRev()) != 0) {
+            m_revs.insert(pathLower, file->getRev());
+            modifiedFiles.append(file);
+        }
+    }
+
+    m_cursor = cursor;
+
+    if (deletedPaths.size()) {
+        emit deleted(deletedPaths);
+    }
+    if (addedFiles.size()) {
+        emit added(addedFiles);
+    }
+    if (modifiedFiles.size()) {
+        emit modified(modifiedFiles);
+    }
+
+    if (m_state == Idle) {
+        return;
+    }
+
+    if (hasMore) {
+        m_state = Continuing;
+        track(m_pDropbox->listFolderContinue(m_cursor));
+    } else {
+        emit synced(m_cursor);
+        if (m_state != Idle) {
+            poll();
+        }
+    }
+}
+
+void QDropboxDeltaSync::poll() {
+    QDateTime now = QDateTime::currentDateTime();
+    if (m_backoffUntil.isValid() && now < m_backoffUntil) {
+        int msec = now.secsTo(m_backoffUntil) * 1000;
+        wait(qMax(msec, 1000), Polling);
+        return;
+    }
+
+    m_state = Polling;
+    track(m_pDropbox->listFolderLongPoll(m_cursor, m_timeout));
+}
+
+void QDropboxDeltaSync::track(QDropboxRequest* request) {
+    m_pRequest = request;
+    bool res = QObject::connect(request, SIGNAL(finished()), this, SLOT(onRequestFinished()));
+    Q_ASSERT(res);
+    res = QObject::connect(request, SIGNAL(failed(QNetworkReply::NetworkError, const QString&)),
+            this, SLOT(onRequestFailed(QNetworkReply::NetworkError, const QString&)));
+    Q_ASSERT(res);
+    Q_UNUSED(res);
+}
+
+void QDropboxDeltaSync::wait(const int& msec, const State& resumeState) {
+    m_resumeState = resumeState;
+    m_state = Waiting;
+    m_timer.start(msec);
+}
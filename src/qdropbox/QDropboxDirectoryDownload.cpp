@@ -0,0 +1,372 @@
+/*
+ * QDropboxDirectoryDownload.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#include "../../include/qdropbox/QDropboxDirectoryDownload.hpp"
+#include "../../include/qdropbox/QDropboxCommon.hpp"
+#include <QDir>
+#include <QStringList>
+
+Logger QDropboxDirectoryDownload::logger = Logger::getLogger("QDropboxDirectoryDownload");
+
+#define CONCURRENCY 4
+#define ZIP_MIN_FILES 32
+#define ZIP_MAX_AVERAGE_SIZE 262144 // 256 KB
+#define ZIP_MAX_FILES 10000 // max allowed by Dropbox
+#define ZIP_MAX_SIZE Q_INT64_C(21474836480) // 20 GB, max allowed by Dropbox
+
+QDropboxDirectoryDownload::QDropboxDirectoryDownload(QDropbox* dropbox, const QString& remotePath, const QString& localPath, QObject* parent) : QObject(parent),
+        m_pDropbox(dropbox), m_remotePath(remotePath), m_localPath(QDir(localPath).absolutePath()), m_concurrency(CONCURRENCY),
+        m_zipMinFiles(ZIP_MIN_FILES), m_zipMaxAverageSize(ZIP_MAX_AVERAGE_SIZE), m_running(false), m_listing(false),
+        m_done(0), m_failures(0), m_received(0), m_total(0) {
+    while (m_remotePath.endsWith("/")) {
+        m_remotePath.chop(1);
+    }
+
+    bool res = QObject::connect(m_pDropbox, SIGNAL(listFolderLoaded(const QString&, QList<QDropboxFile*>&, const QString&, const bool&)),
+            this, SLOT(onListFolderLoaded(const QString&, QList<QDropboxFile*>&, const QString&, const bool&)));
+    Q_ASSERT(res);
+    res = QObject::connect(m_pDropbox, SIGNAL(listFolderContinueLoaded(QList<QDropboxFile*>&, const QString&, const QString&, const bool&)),
+            this, SLOT(onListFolderContinueLoaded(QList<QDropboxFile*>&, const QString&, const QString&, const bool&)));
+    Q_ASSERT(res);
+    res = QObject::connect(m_pDropbox, SIGNAL(downloadProgress(const QString&, qint64, qint64)), this, SLOT(onDownloadProgress(const QString&, qint64, qint64)));
+    Q_ASSERT(res);
+    Q_UNUSED(res);
+}
+
+QDropboxDirectoryDownload::~QDropboxDirectoryDownload() {}
+
+const QString& QDropboxDirectoryDownload::getRemotePath() const { return m_remotePath; }
+
+const QString& QDropboxDirectoryDownload::getLocalPath() const { return m_localPath; }
+
+const int& QDropboxDirectoryDownload::getConcurrency() const { return m_concurrency; }
+QDropboxDirectoryDownload& QDropboxDirectoryDownload::setConcurrency(const int& concurrency) {
+    m_concurrency = qMax(1, concurrency);
+    return *this;
+}
+
+const int& QDropboxDirectoryDownload::getZipMinFiles() const { return m_zipMinFiles; }
+QDropboxDirectoryDownload& QDropboxDirectoryDownload::setZipMinFiles(const int& zipMinFiles) {
+    m_zipMinFiles = zipMinFiles;
+    return *this;
+}
+
+const qint64& QDropboxDirectoryDownload::getZipMaxAverageSize() const { return m_zipMaxAverageSize; }
+QDropboxDirectoryDownload& QDropboxDirectoryDownload::setZipMaxAverageSize(const qint64& zipMaxAverageSize) {
+    m_zipMaxAverageSize = zipMaxAverageSize;
+    return *this;
+}
+
+bool QDropboxDirectoryDownload::isRunning() const {
+    return m_running;
+}
+
+void QDropboxDirectoryDownload::start() {
+    if (m_running) {
+        return;
+    }
+
+    m_running = true;
+    m_cursor = "";
+    m_entries.clear();
+    m_inflight.clear();
+    m_done = 0;
+    m_failures = 0;
+    m_received = 0;
+    m_total = 0;
+    list();
+}
+
+void QDropboxDirectoryDownload::cancel() {
+    if (!m_running) {
+        return;
+    }
+
+    m_running = false;
+    m_listing = false;
+    m_archives.clear();
+    m_files.clear();
+    foreach(QDropboxRequest* request, m_archiveRequests.keys()) {
+        request->cancel();
+    }
+    foreach(QDropboxRequest* request, m_fileRequests.keys()) {
+        request->cancel();
+    }
+}
+
+void QDropboxDirectoryDownload::list() {
+    m_listing = true;
+    QDropboxRequest* request = m_cursor.isEmpty() ? m_pDropbox->listFolder(m_remotePath, false, true) : m_pDropbox->listFolderContinue(m_cursor);
+    bool res = QObject::connect(request, SIGNAL(failed(QNetworkReply::NetworkError, const QString&)),
+            this, SLOT(onListingFailed(QNetworkReply::NetworkError, const QString&)));
+    Q_ASSERT(res);
+    Q_UNUSED(res);
+}
+
+void QDropboxDirectoryDownload::onListFolderLoaded(const QString& path, QList<QDropboxFile*>& files, const QString& cursor, const bool& hasMore) {
+    if (!m_listing || !m_cursor.isEmpty() || path.compare(m_remotePath) != 0) {
+        return;
+    }
+    onListFolderContinueLoaded(files, m_cursor, cursor, hasMore);
+}
+
+void QDropboxDirectoryDownload::onListFolderContinueLoaded(QList<QDropboxFile*>& files, const QString& prevCursor, const QString& cursor, const bool& hasMore) {
+    if (!m_listing || prevCursor.compare(m_cursor) != 0) {
+        return;
+    }
+
+    QString root = m_remotePath.toLower() + "/";
+    foreach(QDropboxFile* file, files) {
+        if (file->getPathLower().startsWith(root) && file->getTag().compare(DELETED_TAG) != 0) {
+            Entry entry;
+            entry.path = file->getPathDisplay().mid(root.size());
+            entry.folder = file->getTag().compare(FOLDER_TAG) == 0;
+            entry.size = file->getSize();
+            entry.rev = file->getRev();
+            entry.contentHash = file->getContentHash();
+            m_entries.append(entry);
+        }
+    }
+
+    m_cursor = cursor;
+    if (hasMore) {
+        list();
+        return;
+    }
+
+    m_listing = false;
+    plan();
+}
+
+void QDropboxDirectoryDownload::onListingFailed(QNetworkReply::NetworkError e, const QString& errorString) {
+    if (!m_listing) {
+        return;
+    }
+
+    m_listing = false;
+    m_running = false;
+    logger.error("Cannot list " + m_remotePath + ": " + errorString);
+    emit failed(errorString);
+    Q_UNUSED(e);
+}
+
+void QDropboxDirectoryDownload::plan() {
+    QHash<QString, int> counts;
+    QHash<QString, qint64> sizes;
+    QHash<QString, QString> folders;
+    folders.insert("", "");
+    QDir().mkpath(m_localPath);
+
+    foreach(Entry entry, m_entries) {
+        QString key = entry.path.toLower();
+        if (entry.folder) {
+            folders.insert(key, entry.path);
+            QDir().mkpath(localFilePath(entry.path));
+            continue;
+        }
+
+        m_total += entry.size;
+        int i = key.length();
+        while (i > 0) {
+            i = key.lastIndexOf('/', i - 1);
+            QString parent = i > 0 ? key.left(i) : QString("");
+            counts[parent]++;
+            sizes[parent] += entry.size;
+        }
+    }
+
+    // the shallowest folders dense with small files are fetched as zips, each one covers its whole subtree
+    QStringList keys = folders.keys();
+    qSort(keys);
+    QStringList zipped;
+    foreach(QString key, keys) {
+        int count = counts.value(key);
+        qint64 size = sizes.value(key);
+        bool covered = false;
+        foreach(QString z, zipped) {
+            covered = covered || z.isEmpty() || key.startsWith(z + "/");
+        }
+        // the root of a Dropbox cannot be zipped
+        if (covered || (key.isEmpty() && m_remotePath.isEmpty())) {
+            continue;
+        }
+        if (count > 0 && count >= m_zipMinFiles && count <= ZIP_MAX_FILES && size <= ZIP_MAX_SIZE && size / count <= m_zipMaxAverageSize) {
+            zipped.append(key);
+            Archive archive;
+            archive.path = folders.value(key);
+            m_archives.append(archive);
+        }
+    }
+
+    int files = 0;
+    foreach(Entry entry, m_entries) {
+        if (entry.folder) {
+            continue;
+        }
+        files++;
+
+        QString key = entry.path.toLower();
+        int archive = -1;
+        for (int i = 0; i < zipped.size() && archive < 0; i++) {
+            if (zipped.at(i).isEmpty() || key.startsWith(zipped.at(i) + "/")) {
+                archive = i;
+            }
+        }
+        if (archive < 0) {
+            m_files.append(entry);
+        } else {
+            m_archives[archive].files.append(entry);
+            m_archives[archive].size += entry.size;
+        }
+    }
+    m_entries.clear();
+
+    logger.info("Downloading " + QString::number(files) + " files of " + m_remotePath + ", " + QString::number(m_archives.size()) + " subtrees as zip");
+    emit planned(files, m_total, m_archives.size());
+    pump();
+}
+
+void QDropboxDirectoryDownload::pump() {
+    if (!m_running) {
+        return;
+    }
+
+    // zips go first, they are the longest downloads
+    while (m_archiveRequests.size() + m_fileRequests.size() < m_concurrency && (!m_archives.isEmpty() || !m_files.isEmpty())) {
+        if (!m_archives.isEmpty()) {
+            startArchive(m_archives.takeFirst());
+        } else {
+            startFile(m_files.takeFirst());
+        }
+    }
+
+    if (m_archiveRequests.isEmpty() && m_fileRequests.isEmpty() && m_archives.isEmpty() && m_files.isEmpty()) {
+        m_running = false;
+        if (m_failures) {
+            emit failed(QString::number(m_failures) + " of " + QString::number(m_done + m_failures) + " downloads failed");
+        } else {
+            emit finished();
+        }
+    }
+}
+
+void QDropboxDirectoryDownload::startArchive(const Archive& archive) {
+    Archive started = archive;
+    started.pExtractor = new QDropboxZipExtractor(localFilePath(archive.path), this);
+    // entries of the zip start with the name of the zipped folder
+    started.pExtractor->setStripComponents(1);
+    started.pExtractor->open(QIODevice::WriteOnly);
+
+    QString remotePath = remoteFilePath(archive.path);
+    QDropboxRequest* request = m_pDropbox->downloadZip(remotePath, started.pExtractor);
+    m_archiveRequests.insert(request, started);
+    m_inflight.insert(remotePath, 0);
+    request->then(this, SLOT(onArchiveDownloaded(const QVariant&)), SLOT(onArchiveFailed(QNetworkReply::NetworkError, const QString&)));
+}
+
+void QDropboxDirectoryDownload::startFile(const Entry& entry) {
+    QString remotePath = remoteFilePath(entry.path);
+    QDropboxRequest* request = m_pDropbox->downloadFile(remotePath, localFilePath(entry.path), entry.rev, entry.contentHash);
+
+    m_fileRequests.insert(request, entry);
+    m_inflight.insert(remotePath, 0);
+    request->then(this, SLOT(onFileDownloaded(const QVariant&)), SLOT(onFileFailed(QNetworkReply::NetworkError, const QString&)));
+}
+
+void QDropboxDirectoryDownload::onDownloadProgress(const QString& path, qint64 loaded, qint64 total) {
+    if (!m_inflight.contains(path)) {
+        return;
+    }
+
+    // a zip counts with what has been extracted from it, the size of the archive itself is unknown
+    qint64 received = loaded;
+    QHash<QDropboxRequest*, Archive>::const_iterator it = m_archiveRequests.constBegin();
+    for (; it != m_archiveRequests.constEnd(); ++it) {
+        if (remoteFilePath(it.value().path).compare(path) == 0) {
+            received = it.value().pExtractor->getExtracted();
+        }
+    }
+    m_inflight.insert(path, received);
+
+    received = m_received;
+    foreach(qint64 inflight, m_inflight.values()) {
+        received += inflight;
+    }
+    emit progress(received, m_total);
+    Q_UNUSED(total);
+}
+
+void QDropboxDirectoryDownload::onFileDownloaded(const QVariant& value) {
+    Entry entry = m_fileRequests.take(qobject_cast<QDropboxRequest*>(QObject::sender()));
+    m_done++;
+    done(remoteFilePath(entry.path), entry.size);
+    pump();
+    Q_UNUSED(value);
+}
+
+void QDropboxDirectoryDownload::onFileFailed(QNetworkReply::NetworkError e, const QString& errorString) {
+    Entry entry = m_fileRequests.take(qobject_cast<QDropboxRequest*>(QObject::sender()));
+    m_failures++;
+    m_inflight.remove(remoteFilePath(entry.path));
+    logger.error("Cannot download " + entry.path + ": " + errorString);
+    pump();
+    Q_UNUSED(e);
+}
+
+void QDropboxDirectoryDownload::onArchiveDownloaded(const QVariant& value) {
+    Archive archive = m_archiveRequests.take(qobject_cast<QDropboxRequest*>(QObject::sender()));
+    QDropboxZipExtractor* extractor = archive.pExtractor;
+    bool complete = extractor->isComplete() && extractor->getFiles().size() >= archive.files.size();
+    QString error = extractor->errorString();
+    extractor->close();
+    extractor->deleteLater();
+
+    if (complete) {
+        m_done += archive.files.size();
+        done(remoteFilePath(archive.path), archive.size);
+    } else {
+        logger.warn("Incomplete zip of " + archive.path + ", downloading its files one by one: " + error);
+        m_inflight.remove(remoteFilePath(archive.path));
+        m_files.append(archive.files);
+    }
+    pump();
+    Q_UNUSED(value);
+}
+
+void QDropboxDirectoryDownload::onArchiveFailed(QNetworkReply::NetworkError e, const QString& errorString) {
+    Archive archive = m_archiveRequests.take(qobject_cast<QDropboxRequest*>(QObject::sender()));
+    archive.pExtractor->close();
+    archive.pExtractor->deleteLater();
+    m_inflight.remove(remoteFilePath(archive.path));
+
+    if (m_running) {
+        // too large, too many files or a transient error, single files still work
+        logger.warn("Cannot download zip of " + archive.path + ", downloading its files one by one: " + errorString);
+        m_files.append(archive.files);
+    }
+    pump();
+    Q_UNUSED(e);
+}
+
+void QDropboxDirectoryDownload::done(const QString& remotePath, const qint64& size) {
+    m_inflight.remove(remotePath);
+    m_received += size;
+
+    qint64 received = m_received;
+    foreach(qint64 inflight, m_inflight.values()) {
+        received += inflight;
+    }
+    emit progress(received, m_total);
+}
+
+QString QDropboxDirectoryDownload::localFilePath(const QString& path) const {
+    return path.isEmpty() ? m_localPath : m_localPath + "/" + path;
+}
+
+QString QDropboxDirectoryDownload::remoteFilePath(const QString& path) const {
+    return path.isEmpty() ? m_remotePath : m_remotePath + "/" + path;
+}
@@ -0,0 +1,345 @@
+/*
+ * QDropboxDirectoryUpload.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#include "../../include/qdropbox/QDropboxDirectoryUpload.hpp"
+#include "../../include/qdropbox/QDropboxJobTracker.hpp"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <QThreadPool>
+
+Logger QDropboxDirectoryUpload::logger = Logger::getLogger("QDropboxDirectoryUpload");
+
+#define CONCURRENCY 4
+#define SMALL_FILE_SIZE 8388608 // 8 MB, one chunk of a session upload
+#define BATCH_SIZE 1000 // max allowed by Dropbox
+
+QDropboxDirectoryUpload::QDropboxDirectoryUpload(QDropbox* dropbox, const QString& localPath, const QString& remotePath, const QString& mode, QObject* parent) : QObject(parent),
+        m_pDropbox(dropbox), m_localPath(QDir(localPath).absolutePath()), m_remotePath(remotePath), m_mode(mode),
+        m_concurrency(CONCURRENCY), m_smallFileSize(SMALL_FILE_SIZE), m_running(false), m_starting(0), m_pBatchRequest(0),
+        m_files(0), m_failures(0), m_sent(0), m_total(0) {
+    while (m_remotePath.endsWith("/")) {
+        m_remotePath.chop(1);
+    }
+
+    bool res = QObject::connect(m_pDropbox->getJobTracker(), SIGNAL(finished(const AsyncJobStatus&)), this, SLOT(onJobFinished(const AsyncJobStatus&)));
+    Q_ASSERT(res);
+    Q_UNUSED(res);
+}
+
+QDropboxDirectoryUpload::~QDropboxDirectoryUpload() {}
+
+const QString& QDropboxDirectoryUpload::getLocalPath() const { return m_localPath; }
+
+const QString& QDropboxDirectoryUpload::getRemotePath() const { return m_remotePath; }
+
+const int& QDropboxDirectoryUpload::getConcurrency() const { return m_concurrency; }
+QDropboxDirectoryUpload& QDropboxDirectoryUpload::setConcurrency(const int& concurrency) {
+    m_concurrency = qMax(1, concurrency);
+    return *this;
+}
+
+const qint64& QDropboxDirectoryUpload::getSmallFileSize() const { return m_smallFileSize; }
+QDropboxDirectoryUpload& QDropboxDirectoryUpload::setSmallFileSize(const qint64& smallFileSize) {
+    m_smallFileSize = smallFileSize;
+    return *this;
+}
+
+bool QDropboxDirectoryUpload::isRunning() const {
+    return m_running;
+}
+
+void QDropboxDirectoryUpload::start() {
+    if (m_running) {
+        return;
+    }
+    if (!QFileInfo(m_localPath).isDir()) {
+        logger.error("Not a directory: " + m_localPath);
+        emit failed("Not a directory: " + m_localPath);
+        return;
+    }
+
+    m_running = true;
+    m_entries.clear();
+    m_commits.clear();
+    m_batch.clear();
+    m_starting = 0;
+    m_jobId = "";
+    m_files = 0;
+    m_failures = 0;
+    m_sent = 0;
+    m_total = 0;
+
+    m_scanners = QDropboxLocalScanner::split(m_localPath);
+    foreach(QDropboxLocalScanner* scanner, m_scanners) {
+        scanner->setHashing(false);
+        bool res = QObject::connect(scanner, SIGNAL(scanned()), this, SLOT(onScanned()));
+        Q_ASSERT(res);
+        Q_UNUSED(res);
+        QThreadPool::globalInstance()->start(scanner);
+    }
+}
+
+void QDropboxDirectoryUpload::cancel() {
+    if (!m_running) {
+        return;
+    }
+
+    m_running = false;
+    m_scanners.clear();
+    m_folders.clear();
+    m_smallFiles.clear();
+    m_largeFiles.clear();
+    m_commits.clear();
+    foreach(QDropboxRequest* request, m_requests.keys()) {
+        request->cancel();
+    }
+    foreach(QDropboxSessionUpload* upload, m_uploads.keys()) {
+        upload->cancel();
+    }
+    if (m_pBatchRequest != 0) {
+        m_pBatchRequest->cancel();
+    }
+    m_jobId = "";
+}
+
+void QDropboxDirectoryUpload::onScanned() {
+    QDropboxLocalScanner* scanner = qobject_cast<QDropboxLocalScanner*>(QObject::sender());
+    scanner->deleteLater();
+    if (!m_scanners.removeOne(scanner)) {
+        return;
+    }
+
+    m_entries.append(scanner->getEntries());
+    if (m_scanners.isEmpty()) {
+        plan();
+    }
+}
+
+void QDropboxDirectoryUpload::plan() {
+    QSet<QString> parents;
+    foreach(LocalEntry entry, m_entries) {
+        int i = entry.path.lastIndexOf('/');
+        while (i > 0) {
+            parents.insert(entry.path.left(i).toLower());
+            i = entry.path.lastIndexOf('/', i - 1);
+        }
+    }
+
+    foreach(LocalEntry entry, m_entries) {
+        if (entry.folder) {
+            // uploads create the folders above them, only empty folders need a call of their own
+            if (!parents.contains(entry.path.toLower())) {
+                m_folders.append(entry);
+            }
+        } else if (entry.size > 0 && entry.size <= m_smallFileSize) {
+            m_smallFiles.append(entry);
+        } else {
+            m_largeFiles.append(entry);
+        }
+        m_total += entry.size;
+    }
+    if (m_entries.isEmpty()) {
+        LocalEntry root;
+        root.folder = true;
+        m_folders.append(root);
+    }
+    m_entries.clear();
+
+    emit planned(m_smallFiles.size() + m_largeFiles.size(), m_total);
+    pump();
+}
+
+void QDropboxDirectoryUpload::pump() {
+    if (!m_running) {
+        return;
+    }
+
+    while (m_requests.size() + m_uploads.size() < m_concurrency && startNext()) {}
+    commit();
+
+    bool idle = m_requests.isEmpty() && m_uploads.isEmpty() && m_pBatchRequest == 0 && m_jobId.isEmpty();
+    bool empty = m_folders.isEmpty() && m_smallFiles.isEmpty() && m_largeFiles.isEmpty() && m_commits.isEmpty();
+    if (idle && empty) {
+        m_running = false;
+        if (m_failures) {
+            emit failed(QString::number(m_failures) + " of " + QString::number(m_files + m_failures) + " uploads failed");
+        } else {
+            emit finished();
+        }
+    }
+}
+
+bool QDropboxDirectoryUpload::startNext() {
+    if (!m_folders.isEmpty()) {
+        LocalEntry entry = m_folders.takeFirst();
+        QDropboxRequest* request = m_pDropbox->createFolder(remoteFilePath(entry.path));
+        m_requests.insert(request, entry);
+        request->then(this, SLOT(onFolderCreated(const QVariant&)), SLOT(onRequestFailed(QNetworkReply::NetworkError, const QString&)));
+        return true;
+    }
+
+    // large files take longest, so they are started before the small ones
+    if (!m_largeFiles.isEmpty()) {
+        LocalEntry entry = m_largeFiles.takeFirst();
+        QDropboxSessionUpload* upload = new QDropboxSessionUpload(m_pDropbox, m_localPath + "/" + entry.path, remoteFilePath(entry.path), m_mode, this);
+        bool res = QObject::connect(upload, SIGNAL(progress(qint64, qint64)), this, SLOT(onUploadProgress(qint64, qint64)));
+        Q_ASSERT(res);
+        res = QObject::connect(upload, SIGNAL(finished(const QVariant&)), this, SLOT(onUploaded(const QVariant&)));
+        Q_ASSERT(res);
+        res = QObject::connect(upload, SIGNAL(failed(const QString&)), this, SLOT(onUploadFailed(const QString&)));
+        Q_ASSERT(res);
+        Q_UNUSED(res);
+        m_uploads.insert(upload, 0);
+        if (!upload->start()) {
+            m_uploads.remove(upload);
+            upload->deleteLater();
+            fail(entry.path, "Cannot open file");
+        }
+        return true;
+    }
+
+    if (!m_smallFiles.isEmpty()) {
+        LocalEntry entry = m_smallFiles.takeFirst();
+        QFile file(m_localPath + "/" + entry.path);
+        QByteArray data;
+        if (file.open(QIODevice::ReadOnly)) {
+            data = file.readAll();
+            file.close();
+        }
+
+        QDropboxRequest* request = m_pDropbox->uploadSessionStart(remoteFilePath(entry.path), data, true);
+        entry.size = data.size();
+        m_requests.insert(request, entry);
+        m_starting++;
+        request->then(this, SLOT(onSessionStarted(const QVariant&)), SLOT(onRequestFailed(QNetworkReply::NetworkError, const QString&)));
+        return true;
+    }
+
+    return false;
+}
+
+void QDropboxDirectoryUpload::onSessionStarted(const QVariant& value) {
+    LocalEntry entry = m_requests.take(qobject_cast<QDropboxRequest*>(QObject::sender()));
+    m_starting--;
+
+    UploadSessionEntry commit;
+    commit.sessionId = value.toMap().value("session_id").toString();
+    commit.offset = entry.size;
+    commit.path = remoteFilePath(entry.path);
+    commit.mode = m_mode;
+    m_commits.append(commit);
+
+    m_sent += entry.size;
+    emit progress(m_sent, m_total);
+    pump();
+}
+
+void QDropboxDirectoryUpload::onFolderCreated(const QVariant& value) {
+    m_requests.remove(qobject_cast<QDropboxRequest*>(QObject::sender()));
+    pump();
+    Q_UNUSED(value);
+}
+
+void QDropboxDirectoryUpload::onRequestFailed(QNetworkReply::NetworkError e, const QString& errorString) {
+    LocalEntry entry = m_requests.take(qobject_cast<QDropboxRequest*>(QObject::sender()));
+    if (!entry.folder) {
+        m_starting--;
+    }
+    fail(entry.path, errorString);
+    pump();
+    Q_UNUSED(e);
+}
+
+void QDropboxDirectoryUpload::onUploadProgress(qint64 sent, qint64 total) {
+    QDropboxSessionUpload* upload = qobject_cast<QDropboxSessionUpload*>(QObject::sender());
+    m_sent += sent - m_uploads.value(upload);
+    m_uploads.insert(upload, sent);
+    emit progress(m_sent, m_total);
+    Q_UNUSED(total);
+}
+
+void QDropboxDirectoryUpload::onUploaded(const QVariant& metadata) {
+    QDropboxSessionUpload* upload = qobject_cast<QDropboxSessionUpload*>(QObject::sender());
+    m_uploads.remove(upload);
+    upload->deleteLater();
+    m_files++;
+    pump();
+    Q_UNUSED(metadata);
+}
+
+void QDropboxDirectoryUpload::onUploadFailed(const QString& reason) {
+    QDropboxSessionUpload* upload = qobject_cast<QDropboxSessionUpload*>(QObject::sender());
+    m_uploads.remove(upload);
+    upload->deleteLater();
+    fail(upload->getLocalPath(), reason);
+    pump();
+}
+
+void QDropboxDirectoryUpload::commit() {
+    if (m_pBatchRequest != 0 || !m_jobId.isEmpty() || m_commits.isEmpty()) {
+        return;
+    }
+    // a batch is sent once full or once no more sessions are on their way
+    if (m_commits.size() < BATCH_SIZE && (m_starting > 0 || !m_smallFiles.isEmpty())) {
+        return;
+    }
+
+    m_batch = m_commits.mid(0, BATCH_SIZE);
+    m_commits = m_commits.mid(m_batch.size());
+    m_pBatchRequest = m_pDropbox->uploadSessionFinishBatch(m_batch);
+    m_pBatchRequest->then(this, SLOT(onBatchLaunched(const QVariant&)), SLOT(onBatchFailed(QNetworkReply::NetworkError, const QString&)));
+}
+
+void QDropboxDirectoryUpload::onBatchLaunched(const QVariant& value) {
+    m_pBatchRequest = 0;
+    QVariantMap map = value.toMap();
+    if (map.value(".tag").toString().compare("async_job_id") == 0) {
+        m_jobId = map.value("async_job_id").toString();
+        return;
+    }
+    batchDone(map.value("entries").toList(), true);
+}
+
+void QDropboxDirectoryUpload::onBatchFailed(QNetworkReply::NetworkError e, const QString& errorString) {
+    m_pBatchRequest = 0;
+    logger.error("Batch failed: " + errorString);
+    batchDone(QVariantList(), false);
+    Q_UNUSED(e);
+}
+
+void QDropboxDirectoryUpload::onJobFinished(const AsyncJobStatus& status) {
+    if (m_jobId.isEmpty() || status.asyncJobId.compare(m_jobId) != 0) {
+        return;
+    }
+
+    m_jobId = "";
+    batchDone(status.entries, status.status == AsyncJobStatus::Complete);
+}
+
+void QDropboxDirectoryUpload::batchDone(const QVariantList& entries, const bool& ok) {
+    for (int i = 0; i < m_batch.size(); i++) {
+        QVariantMap entry = i < entries.size() ? entries.at(i).toMap() : QVariantMap();
+        if (ok && entry.value(".tag").toString().compare("failure") != 0) {
+            m_files++;
+        } else {
+            fail(m_batch.at(i).path, "Commit failed");
+        }
+    }
+    m_batch.clear();
+    pump();
+}
+
+void QDropboxDirectoryUpload::fail(const QString& path, const QString& reason) {
+    m_failures++;
+    logger.error("Cannot upload " + path + ": " + reason);
+}
+
+QString QDropboxDirectoryUpload::remoteFilePath(const QString& path) const {
+    return path.isEmpty() ? m_remotePath : m_remotePath + "/" + path;
+}
@@ -8,16 +8,22 @@
 #include "../../include/qdropbox/QDropboxFile.hpp"
 #include "../../include/qdropbox/QDropboxCommon.hpp"
 
-QDropboxFile::QDropboxFile(QObject* parent) : QObject(parent), m_tag(""), m_name(""), m_pathLower(""), m_pathDisplay(""), m_id(""), m_sharedFolderId(""),
+QDropboxFile::QDropboxFile(QObject* parent) : QObject(parent), m_tag(""), m_name(""), m_pPath(0), m_id(""), m_sharedFolderId(""),
 m_sharingInfo(0), m_clientModified(""), m_serverModified(""), m_rev(""), m_size(0), m_contentHash(""), m_mediaInfo(0) {}
 
-QDropboxFile::QDropboxFile(const QDropboxFile& file) : QObject(file.parent()) {
+QDropboxFile::QDropboxFile(const QDropboxFile& file) : QObject(file.parent()), m_pPath(0), m_sharingInfo(0), m_size(0), m_mediaInfo(0) {
     if (this != &file) {
         swap(file);
     }
 }
 
 QDropboxFile::~QDropboxFile() {
+    QDropboxPathTree* pathTree = QDropboxPathTree::instance();
+    if (pathTree != 0) {
+        pathTree->release(m_pPath);
+    }
+    m_pPath = 0;
+
     if (m_sharingInfo != 0) {
         delete m_sharingInfo;
         m_sharingInfo = 0;
@@ -56,15 +62,17 @@ QDropboxFile& QDropboxFile::setName(const QString& name) {
     return *this;
 }
 
-const QString& QDropboxFile::getPathLower() const { return m_pathLower; }
+QString QDropboxFile::getPathLower() const { return QDropboxPathTree::instance()->pathLower(m_pPath); }
 QDropboxFile& QDropboxFile::setPathLower(const QString& pathLower) {
-    m_pathLower = pathLower;
+    QString pathDisplay = getPathDisplay();
+    setPath(pathLower, pathDisplay.toLower().compare(pathLower) == 0 ? pathDisplay : pathLower);
     return *this;
 }
 
-const QString& QDropboxFile::getPathDisplay() const { return m_pathDisplay; }
+QString QDropboxFile::getPathDisplay() const { return QDropboxPathTree::instance()->pathDisplay(m_pPath); }
 QDropboxFile& QDropboxFile::setPathDisplay(const QString& pathDisplay) {
-    m_pathDisplay = pathDisplay;
+    QString pathLower = getPathLower();
+    setPath(pathLower.isEmpty() || pathLower.split("/").size() != pathDisplay.split("/").size() ? pathDisplay.toLower() : pathLower, pathDisplay);
     return *this;
 }
 
@@ -133,8 +141,7 @@ QDropboxFile& QDropboxFile::setMediaInfo(MediaInfo* mediaInfo) {
 void QDropboxFile::fromMap(const QVariantMap& map) {
     m_tag = map.value(".tag").toString();
     m_name = map.value("name").toString();
-    m_pathLower = map.value("path_lower").toString();
-    m_pathDisplay = map.value("path_display").toString();
+    setPath(map.value("path_lower").toString(), map.value("path_display").toString());
     m_id = map.value("id").toString();
     m_sharedFolderId = map.value("shared_folder_id", "").toString();
 
@@ -163,8 +170,8 @@ QVariantMap QDropboxFile::toMap() {
     QVariantMap map;
     map[".tag"] = m_tag;
     map["name"] = m_name;
-    map["path_lower"] = m_pathLower;
-    map["path_display"] = m_pathDisplay;
+    map["path_lower"] = getPathLower();
+    map["path_display"] = getPathDisplay();
     map["id"] = m_id;
     map["shared_folder_id"] = m_sharedFolderId;
 
@@ -189,8 +196,9 @@ QVariantMap QDropboxFile::toMap() {
 void QDropboxFile::swap(const QDropboxFile& file) {
     m_tag = file.getTag();
     m_name = file.getName();
-    m_pathLower = file.getPathLower();
-    m_pathDisplay = file.getPathDisplay();
+    QDropboxPathTree::Node* path = QDropboxPathTree::instance()->retain(file.m_pPath);
+    QDropboxPathTree::instance()->release(m_pPath);
+    m_pPath = path;
     m_id = file.getId();
     m_sharedFolderId = file.getSharedFolderId();
 
@@ -215,3 +223,8 @@ void QDropboxFile::swap(const QDropboxFile& file) {
     }
 }
 
+void QDropboxFile::setPath(const QString& pathLower, const QString& pathDisplay) {
+    QDropboxPathTree::Node* path = QDropboxPathTree::instance()->acquire(pathLower, pathDisplay);
+    QDropboxPathTree::instance()->release(m_pPath);
+    m_pPath = path;
+}
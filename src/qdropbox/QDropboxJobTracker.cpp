@@ -0,0 +1,184 @@
+/*
+ * QDropboxJobTracker.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#include "../../include/qdropbox/QDropboxJobTracker.hpp"
+#include <QDateTime>
+#include <QStringList>
+
+Logger QDropboxJobTracker::logger = Logger::getLogger("QDropboxJobTracker");
+
+#define MIN_INTERVAL 250
+#define MAX_INTERVAL 10000
+#define CHECK_TIMEOUT 30000
+#define MAX_FAILED_CHECKS 5
+
+QDropboxJobTracker::QDropboxJobTracker(QDropbox* dropbox, QObject* parent) : QObject(parent),
+        m_pDropbox(dropbox), m_minInterval(MIN_INTERVAL), m_maxInterval(MAX_INTERVAL) {
+    m_timer.setSingleShot(true);
+
+    bool res = QObject::connect(&m_timer, SIGNAL(timeout()), this, SLOT(checkDue()));
+    Q_ASSERT(res);
+    res = QObject::connect(m_pDropbox, SIGNAL(asyncJobLaunched(const QString&, const QString&)), this, SLOT(track(const QString&, const QString&)));
+    Q_ASSERT(res);
+    res = QObject::connect(m_pDropbox, SIGNAL(asyncJobChecked(const AsyncJobStatus&)), this, SLOT(onAsyncJobChecked(const AsyncJobStatus&)));
+    Q_ASSERT(res);
+    Q_UNUSED(res);
+}
+
+QDropboxJobTracker::~QDropboxJobTracker() {}
+
+const int& QDropboxJobTracker::getMinInterval() const { return m_minInterval; }
+QDropboxJobTracker& QDropboxJobTracker::setMinInterval(const int& minInterval) {
+    m_minInterval = minInterval;
+    return *this;
+}
+
+const int& QDropboxJobTracker::getMaxInterval() const { return m_maxInterval; }
+QDropboxJobTracker& QDropboxJobTracker::setMaxInterval(const int& maxInterval) {
+    m_maxInterval = maxInterval;
+    return *this;
+}
+
+bool QDropboxJobTracker::isTracking(const QString& asyncJobId) const {
+    return m_jobs.contains(asyncJobId);
+}
+
+int QDropboxJobTracker::size() const {
+    return m_jobs.size();
+}
+
+void QDropboxJobTracker::track(const QString& type, const QString& asyncJobId) {
+    if (asyncJobId.isEmpty() || m_jobs.contains(asyncJobId)) {
+        return;
+    }
+
+    Job job;
+    job.type = type;
+    job.interval = m_minInterval;
+    job.nextCheck = QDateTime::currentMSecsSinceEpoch() + job.interval;
+    m_jobs.insert(asyncJobId, job);
+    schedule();
+}
+
+void QDropboxJobTracker::untrack(const QString& asyncJobId) {
+    m_jobs.remove(asyncJobId);
+    schedule();
+}
+
+void QDropboxJobTracker::onAsyncJobChecked(const AsyncJobStatus& status) {
+    if (!m_jobs.contains(status.asyncJobId)) {
+        return;
+    }
+
+    if (status.status == AsyncJobStatus::InProgress) {
+        Job& job = m_jobs[status.asyncJobId];
+        job.checkSent = 0;
+        job.failures = 0;
+        job.interval = qMin(job.interval * 2, m_maxInterval);
+        job.nextCheck = QDateTime::currentMSecsSinceEpoch() + job.interval;
+        schedule();
+        return;
+    }
+
+    m_jobs.remove(status.asyncJobId);
+    schedule();
+
+    if (status.status == AsyncJobStatus::Complete) {
+        emit completed(status);
+    } else {
+        logger.error("Async job failed: " + status.type + " " + status.asyncJobId);
+        emit failed(status);
+    }
+    emit finished(status);
+}
+
+void QDropboxJobTracker::onCheckSucceeded(const QVariant& value) {
+    // the status itself arrives through asyncJobChecked()
+    m_checks.remove(qobject_cast<QDropboxRequest*>(QObject::sender()));
+    Q_UNUSED(value);
+}
+
+void QDropboxJobTracker::onCheckFailed(QNetworkReply::NetworkError e, const QString& errorString) {
+    QString asyncJobId = m_checks.take(qobject_cast<QDropboxRequest*>(QObject::sender()));
+    if (!m_jobs.contains(asyncJobId)) {
+        // a job the server reported as failed is settled through asyncJobChecked() already
+        return;
+    }
+
+    // errors of the connection and unknown server errors may pass, anything else will not go away by asking again
+    Job& job = m_jobs[asyncJobId];
+    bool transient = e < QNetworkReply::ContentAccessDenied || e == QNetworkReply::UnknownContentError;
+    if (transient && ++job.failures < MAX_FAILED_CHECKS) {
+        logger.warn("Cannot check async job " + asyncJobId + ", checking again: " + errorString);
+        job.checkSent = 0;
+        job.nextCheck = QDateTime::currentMSecsSinceEpoch() + job.interval;
+        schedule();
+        return;
+    }
+    fail(asyncJobId, errorString);
+}
+
+void QDropboxJobTracker::checkDue() {
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    QStringList refused;
+    QHash<QString, Job>::iterator it = m_jobs.begin();
+    for (; it != m_jobs.end(); ++it) {
+        Job& job = it.value();
+        // a check without an answer is considered lost after a while and sent again
+        if (job.checkSent != 0 && now - job.checkSent < CHECK_TIMEOUT) {
+            continue;
+        }
+        if (job.nextCheck <= now) {
+            job.checkSent = now;
+            job.nextCheck = now + CHECK_TIMEOUT;
+            QDropboxRequest* check = m_pDropbox->checkJob(job.type, it.key());
+            if (check == 0) {
+                refused.append(it.key());
+                continue;
+            }
+            m_checks.insert(check, it.key());
+            bool res = QObject::connect(check, SIGNAL(failed(QNetworkReply::NetworkError, const QString&)), this, SLOT(onCheckFailed(QNetworkReply::NetworkError, const QString&)));
+            Q_ASSERT(res);
+            res = QObject::connect(check, SIGNAL(succeeded(const QVariant&)), this, SLOT(onCheckSucceeded(const QVariant&)));
+            Q_ASSERT(res);
+            Q_UNUSED(res);
+        }
+    }
+    foreach(QString asyncJobId, refused) {
+        fail(asyncJobId, "Cannot check async job of type " + m_jobs.value(asyncJobId).type);
+    }
+    schedule();
+}
+
+void QDropboxJobTracker::fail(const QString& asyncJobId, const QString& errorString) {
+    AsyncJobStatus status;
+    status.type = m_jobs.take(asyncJobId).type;
+    status.asyncJobId = asyncJobId;
+    status.status = AsyncJobStatus::Failed;
+    status.result["error_summary"] = errorString;
+    schedule();
+
+    logger.error("Async job failed: " + status.type + " " + asyncJobId + ": " + errorString);
+    emit failed(status);
+    emit finished(status);
+}
+
+void QDropboxJobTracker::schedule() {
+    if (m_jobs.isEmpty()) {
+        m_timer.stop();
+        return;
+    }
+
+    qint64 next = 0;
+    foreach(Job job, m_jobs) {
+        if (next == 0 || job.nextCheck < next) {
+            next = job.nextCheck;
+        }
+    }
+    m_timer.start((int) qMax((qint64) 0, next - QDateTime::currentMSecsSinceEpoch()));
+}
@@ -0,0 +1,88 @@
+/*
+ * QDropboxLocalScanner.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#include "../../include/qdropbox/QDropboxLocalScanner.hpp"
+#include "../../include/qdropbox/QDropboxContentHash.hpp"
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QDateTime>
+
+#define PART_SUFFIX ".part"
+
+QDropboxLocalScanner::QDropboxLocalScanner(const QString& root, const QString& directory, const bool& recursive, QObject* parent) : QObject(parent),
+        m_root(QDir(root).absolutePath()), m_directory(directory), m_recursive(recursive), m_hashing(true) {
+    setAutoDelete(false);
+}
+
+QDropboxLocalScanner::~QDropboxLocalScanner() {}
+
+void QDropboxLocalScanner::run() {
+    QDir root(m_root);
+    QString directory = m_directory.isEmpty() ? m_root : root.absoluteFilePath(m_directory);
+    QDirIterator it(directory, QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden,
+            m_recursive ? QDirIterator::Subdirectories : QDirIterator::NoIteratorFlags);
+
+    while (it.hasNext()) {
+        it.next();
+        QFileInfo info = it.fileInfo();
+        // unfinished downloads are not part of the tree
+        if (info.isSymLink() || info.fileName().endsWith(PART_SUFFIX)) {
+            continue;
+        }
+
+        LocalEntry entry;
+        entry.path = root.relativeFilePath(info.absoluteFilePath());
+        entry.folder = info.isDir();
+        if (!entry.folder) {
+            entry.size = info.size();
+            entry.modified = info.lastModified().toMSecsSinceEpoch();
+            if (m_hashing) {
+                const LocalEntry known = m_known.value(entry.path.toLower());
+                bool unchanged = known.size == entry.size && known.modified == entry.modified && !known.contentHash.isEmpty();
+                entry.contentHash = unchanged ? known.contentHash : QDropboxContentHash::file(info.absoluteFilePath());
+            }
+        }
+        m_entries.append(entry);
+    }
+
+    emit scanned();
+}
+
+const QString& QDropboxLocalScanner::getRoot() const { return m_root; }
+
+const QString& QDropboxLocalScanner::getDirectory() const { return m_directory; }
+
+const bool& QDropboxLocalScanner::isHashing() const { return m_hashing; }
+QDropboxLocalScanner& QDropboxLocalScanner::setHashing(const bool& hashing) {
+    m_hashing = hashing;
+    return *this;
+}
+
+QDropboxLocalScanner& QDropboxLocalScanner::setKnown(const QHash<QString, LocalEntry>& known) {
+    m_known = known;
+    return *this;
+}
+
+const QList<LocalEntry>& QDropboxLocalScanner::getEntries() const { return m_entries; }
+
+QList<QDropboxLocalScanner*> QDropboxLocalScanner::split(const QString& root, const QHash<QString, LocalEntry>& known) {
+    QList<QDropboxLocalScanner*> scanners;
+
+    // the top level on its own, then one recursive walk per top-level directory
+    QDropboxLocalScanner* top = new QDropboxLocalScanner(root, "", false);
+    top->setKnown(known);
+    scanners.append(top);
+
+    QDir dir(root);
+    foreach(QString name, dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::NoSymLinks)) {
+        QDropboxLocalScanner* scanner = new QDropboxLocalScanner(root, name, true);
+        scanner->setKnown(known);
+        scanners.append(scanner);
+    }
+    return scanners;
+}
@@ -0,0 +1,163 @@
+/*
+ * QDropboxPathTree.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#include "../../include/qdropbox/QDropboxPathTree.hpp"
+#include <QMutexLocker>
+
+Q_GLOBAL_STATIC(QDropboxPathTree, globalPathTree)
+
+QDropboxPathTree::QDropboxPathTree() : m_size(0) {}
+
+QDropboxPathTree::~QDropboxPathTree() {
+    foreach(Node* child, m_root.children) {
+        destroy(child);
+    }
+    m_root.children.clear();
+}
+
+QDropboxPathTree* QDropboxPathTree::instance() {
+    return globalPathTree();
+}
+
+QDropboxPathTree::Node* QDropboxPathTree::acquire(const QString& pathLower, const QString& pathDisplay) {
+    QStringList lowerSegments = pathLower.split("/", QString::SkipEmptyParts);
+    if (lowerSegments.isEmpty()) {
+        return 0;
+    }
+    QStringList displaySegments = pathDisplay.split("/", QString::SkipEmptyParts);
+    if (displaySegments.size() != lowerSegments.size()) {
+        displaySegments = lowerSegments;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    Node* node = &m_root;
+    for (int i = 0; i < lowerSegments.size(); i++) {
+        const QString& segment = lowerSegments.at(i);
+        const QString& display = displaySegments.at(i);
+        Node* child = 0;
+        foreach(Node* sibling, node->children.values(segment)) {
+            if (sibling->display.compare(display) == 0) {
+                child = sibling;
+                break;
+            }
+        }
+        if (child == 0) {
+            child = new Node(node);
+            child->lower = segment;
+            child->display = display.compare(segment) == 0 ? segment : display;
+            node->children.insert(segment, child);
+            m_size++;
+        }
+        node = child;
+    }
+    node->refs.ref();
+    return node;
+}
+
+QDropboxPathTree::Node* QDropboxPathTree::retain(Node* node) {
+    // the caller holds the node already, it cannot be pruned meanwhile
+    if (node != 0) {
+        node->refs.ref();
+    }
+    return node;
+}
+
+void QDropboxPathTree::release(Node* node) {
+    if (node == 0) {
+        return;
+    }
+    forever {
+        int refs = node->refs;
+        if (refs <= 1) {
+            break;
+        }
+        if (node->refs.testAndSetOrdered(refs, refs - 1)) {
+            return;
+        }
+    }
+
+    // the last holder lets go under the lock, so acquire() never hands out a node being pruned
+    QMutexLocker locker(&m_mutex);
+    if (node->refs.deref()) {
+        return;
+    }
+    while (node != &m_root && node->refs == 0 && node->children.isEmpty()) {
+        Node* parent = node->parent;
+        parent->children.remove(node->lower, node);
+        delete node;
+        m_size--;
+        node = parent;
+    }
+}
+
+QString QDropboxPathTree::pathLower(const Node* node) const {
+    return path(node, false);
+}
+
+QString QDropboxPathTree::pathDisplay(const Node* node) const {
+    return path(node, true);
+}
+
+bool QDropboxPathTree::contains(const QString& pathLower) const {
+    QList<const Node*> found;
+    QMutexLocker locker(&m_mutex);
+    find(&m_root, pathLower.split("/", QString::SkipEmptyParts), 0, found);
+    return !found.isEmpty();
+}
+
+QStringList QDropboxPathTree::subtree(const QString& pathLower, const bool& display) const {
+    QStringList list;
+    QList<const Node*> found;
+    QMutexLocker locker(&m_mutex);
+    find(&m_root, pathLower.split("/", QString::SkipEmptyParts), 0, found);
+    foreach(const Node* node, found) {
+        foreach(Node* child, node->children) {
+            collect(child, list, display);
+        }
+    }
+    return list;
+}
+
+int QDropboxPathTree::size() const {
+    QMutexLocker locker(&m_mutex);
+    return m_size;
+}
+
+void QDropboxPathTree::find(const Node* node, const QStringList& segments, const int& index, QList<const Node*>& found) const {
+    if (index == segments.size()) {
+        found.append(node);
+        return;
+    }
+    foreach(Node* child, node->children.values(segments.at(index))) {
+        find(child, segments, index + 1, found);
+    }
+}
+
+void QDropboxPathTree::collect(const Node* node, QStringList& list, const bool& display) const {
+    if (node->refs > 0) {
+        list.append(path(node, display));
+    }
+    foreach(Node* child, node->children) {
+        collect(child, list, display);
+    }
+}
+
+QString QDropboxPathTree::path(const Node* node, const bool& display) const {
+    QStringList segments;
+    while (node != 0 && node != &m_root) {
+        segments.prepend(display ? node->display : node->lower);
+        node = node->parent;
+    }
+    return segments.isEmpty() ? QString("") : QString("/").append(segments.join("/"));
+}
+
+void QDropboxPathTree::destroy(Node* node) {
+    foreach(Node* child, node->children) {
+        destroy(child);
+    }
+    delete node;
+}
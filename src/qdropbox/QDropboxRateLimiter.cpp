@@ -0,0 +1,99 @@
+/*
+ * QDropboxRateLimiter.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#include "../../include/qdropbox/QDropboxRateLimiter.hpp"
+#include <QHash>
+#include <QDateTime>
+#include <QMutexLocker>
+
+#define DEFAULT_RATE 20.0 // requests per second
+#define DEFAULT_BURST 20
+
+typedef QHash<QString, QSharedPointer<QDropboxRateLimiter> > RateLimiters;
+Q_GLOBAL_STATIC(RateLimiters, globalRateLimiters)
+Q_GLOBAL_STATIC(QMutex, globalRateLimitersMutex)
+
+QDropboxRateLimiter::QDropboxRateLimiter() : m_rate(DEFAULT_RATE), m_burst(DEFAULT_BURST), m_tokens(DEFAULT_BURST),
+        m_updated(QDateTime::currentMSecsSinceEpoch()), m_pausedUntil(0) {}
+
+QDropboxRateLimiter::~QDropboxRateLimiter() {}
+
+QSharedPointer<QDropboxRateLimiter> QDropboxRateLimiter::forNamespace(const QString& key) {
+    QMutexLocker locker(globalRateLimitersMutex());
+    RateLimiters* limiters = globalRateLimiters();
+    QSharedPointer<QDropboxRateLimiter> limiter = limiters->value(key);
+    if (limiter.isNull()) {
+        // an idle limiter behaves like a new one, callers still holding it keep it alive
+        RateLimiters::iterator it = limiters->begin();
+        while (it != limiters->end()) {
+            it = it.value()->isIdle() ? limiters->erase(it) : it + 1;
+        }
+        limiter = QSharedPointer<QDropboxRateLimiter>(new QDropboxRateLimiter());
+        limiters->insert(key, limiter);
+    }
+    return limiter;
+}
+
+double QDropboxRateLimiter::getRate() const {
+    QMutexLocker locker(&m_mutex);
+    return m_rate;
+}
+
+int QDropboxRateLimiter::getBurst() const {
+    QMutexLocker locker(&m_mutex);
+    return m_burst;
+}
+
+void QDropboxRateLimiter::setRate(const double& rate, const int& burst) {
+    QMutexLocker locker(&m_mutex);
+    refill(QDateTime::currentMSecsSinceEpoch());
+    m_rate = qMax(0.001, rate);
+    m_burst = qMax(1, burst);
+    m_tokens = qMin(m_tokens, (double) m_burst);
+}
+
+int QDropboxRateLimiter::acquire() {
+    QMutexLocker locker(&m_mutex);
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (m_pausedUntil > now) {
+        return (int) (m_pausedUntil - now);
+    }
+
+    refill(now);
+    if (m_tokens >= 1.0) {
+        m_tokens -= 1.0;
+        return 0;
+    }
+    return qMax(1, (int) ((1.0 - m_tokens) * 1000.0 / m_rate));
+}
+
+void QDropboxRateLimiter::pause(const int& msec) {
+    QMutexLocker locker(&m_mutex);
+    qint64 until = QDateTime::currentMSecsSinceEpoch() + msec;
+    if (until > m_pausedUntil) {
+        // tokens only start accruing again once the pause is over
+        m_pausedUntil = until;
+        m_tokens = 0;
+        m_updated = until;
+    }
+}
+
+bool QDropboxRateLimiter::isIdle() const {
+    QMutexLocker locker(&m_mutex);
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (m_pausedUntil > now || m_rate != DEFAULT_RATE || m_burst != DEFAULT_BURST) {
+        return false;
+    }
+    return m_tokens + (now - m_updated) * m_rate / 1000.0 >= m_burst;
+}
+
+void QDropboxRateLimiter::refill(const qint64& now) {
+    if (now > m_updated) {
+        m_tokens = qMin((double) m_burst, m_tokens + (now - m_updated) * m_rate / 1000.0);
+        m_updated = now;
+    }
+}
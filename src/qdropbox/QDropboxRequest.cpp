@@ -0,0 +1,233 @@
+/*
+ * QDropboxRequest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#include "../../include/qdropbox/QDropboxRequest.hpp"
+#include <QDateTime>
+
+QDropboxRequest::QDropboxRequest(const QNetworkRequest& request, const QByteArray& data, const char* slot, QObject* parent) : QObject(parent),
+        m_request(request), m_data(data), m_idempotent(true), m_reportErrors(true), m_attempts(0), m_notBefore(0),
+        m_timeout(0), m_stallTimeout(0), m_createdAt(QDateTime::currentMSecsSinceEpoch()), m_startedAt(0), m_lastActivity(0), m_finishedAt(0),
+        m_cancelled(false), m_timedOut(false), m_finished(false), m_pReply(0), m_pAwaiting(0) {
+    m_slot = methodName(slot);
+}
+
+QDropboxRequest::~QDropboxRequest() {}
+
+const QNetworkRequest& QDropboxRequest::getRequest() const { return m_request; }
+
+const QByteArray& QDropboxRequest::getData() const { return m_data; }
+
+const QByteArray& QDropboxRequest::getSlot() const { return m_slot; }
+
+const QDropboxRequestContext& QDropboxRequest::getContext() const { return m_context; }
+QDropboxRequestContext& QDropboxRequest::getContext() { return m_context; }
+
+const QString& QDropboxRequest::getNamespace() const { return m_namespace; }
+QDropboxRequest& QDropboxRequest::setNamespace(const QString& ns) {
+    m_namespace = ns;
+    return *this;
+}
+
+const bool& QDropboxRequest::isIdempotent() const { return m_idempotent; }
+QDropboxRequest& QDropboxRequest::setIdempotent(const bool& idempotent) {
+    m_idempotent = idempotent;
+    return *this;
+}
+
+const bool& QDropboxRequest::isReportErrors() const { return m_reportErrors; }
+QDropboxRequest& QDropboxRequest::setReportErrors(const bool& reportErrors) {
+    m_reportErrors = reportErrors;
+    return *this;
+}
+
+const int& QDropboxRequest::getAttempts() const { return m_attempts; }
+QDropboxRequest& QDropboxRequest::setAttempts(const int& attempts) {
+    m_attempts = attempts;
+    return *this;
+}
+
+const qint64& QDropboxRequest::getNotBefore() const { return m_notBefore; }
+QDropboxRequest& QDropboxRequest::setNotBefore(const qint64& notBefore) {
+    m_notBefore = notBefore;
+    return *this;
+}
+
+const int& QDropboxRequest::getTimeout() const { return m_timeout; }
+QDropboxRequest& QDropboxRequest::setTimeout(const int& timeout) {
+    m_timeout = timeout;
+    return *this;
+}
+
+const int& QDropboxRequest::getStallTimeout() const { return m_stallTimeout; }
+QDropboxRequest& QDropboxRequest::setStallTimeout(const int& stallTimeout) {
+    m_stallTimeout = stallTimeout;
+    return *this;
+}
+
+QNetworkReply* QDropboxRequest::getReply() const { return m_pReply; }
+QDropboxRequest& QDropboxRequest::setReply(QNetworkReply* reply) {
+    m_pReply = reply;
+    if (m_pReply != 0) {
+        m_startedAt = QDateTime::currentMSecsSinceEpoch();
+        m_lastActivity = m_startedAt;
+    }
+    return *this;
+}
+
+const qint64& QDropboxRequest::getCreatedAt() const { return m_createdAt; }
+
+const qint64& QDropboxRequest::getStartedAt() const { return m_startedAt; }
+
+const qint64& QDropboxRequest::getFinishedAt() const { return m_finishedAt; }
+
+const bool& QDropboxRequest::isCancelled() const { return m_cancelled; }
+
+const bool& QDropboxRequest::isTimedOut() const { return m_timedOut; }
+
+const bool& QDropboxRequest::isFinished() const { return m_finished; }
+
+bool QDropboxRequest::isExpired(const qint64& now) const {
+    if (m_pReply == 0 || m_cancelled || m_timedOut) {
+        return false;
+    }
+    return (m_timeout > 0 && now - m_startedAt > m_timeout) || (m_stallTimeout > 0 && now - m_lastActivity > m_stallTimeout);
+}
+
+void QDropboxRequest::expire() {
+    m_timedOut = true;
+    if (m_pReply != 0 && !m_pReply->isFinished()) {
+        m_pReply->abort();
+    }
+}
+
+void QDropboxRequest::finish() {
+    if (m_finished) {
+        return;
+    }
+    m_finished = true;
+    m_finishedAt = QDateTime::currentMSecsSinceEpoch();
+    emit finished();
+    if (m_result.isOk()) {
+        emit succeeded(m_result.value);
+    } else {
+        emit failed(m_result.error, m_result.errorString);
+    }
+
+    QList<Continuation> continuations = m_continuations;
+    m_continuations.clear();
+    foreach(Continuation continuation, continuations) {
+        QDropboxRequest* returned = run(continuation);
+        if (returned != 0) {
+            // the continuation started another call, its handle settles with that one
+            bool res = QObject::connect(returned, SIGNAL(finished()), continuation.next, SLOT(onSourceFinished()));
+            Q_ASSERT(res);
+            Q_UNUSED(res);
+        } else {
+            continuation.next->settleWith(m_result);
+        }
+    }
+
+#if defined(__cpp_impl_coroutine)
+    if (m_pAwaiting != 0) {
+        void* awaiting = m_pAwaiting;
+        m_pAwaiting = 0;
+        std::coroutine_handle<>::from_address(awaiting).resume();
+    }
+#endif
+}
+
+const QDropboxResult& QDropboxRequest::getResult() const { return m_result; }
+
+void QDropboxRequest::resolve(const QVariant& value) {
+    m_result = QDropboxResult();
+    m_result.value = value;
+}
+
+void QDropboxRequest::reject(const QNetworkReply::NetworkError& error, const QString& errorString) {
+    m_result = QDropboxResult();
+    m_result.error = error;
+    m_result.errorString = errorString;
+}
+
+bool QDropboxRequest::isAwaited() const {
+    return m_pAwaiting != 0 || !m_continuations.isEmpty() || receivers(SIGNAL(succeeded(const QVariant&))) > 0;
+}
+
+QDropboxRequest* QDropboxRequest::then(QObject* receiver, const char* onSucceeded, const char* onFailed) {
+    Continuation continuation;
+    continuation.receiver = receiver;
+    continuation.onSucceeded = methodName(onSucceeded);
+    continuation.onFailed = methodName(onFailed);
+    continuation.next = new QDropboxRequest(m_request, QByteArray(), 0, parent());
+    continuation.next->m_context = m_context;
+    m_continuations.append(continuation);
+    return continuation.next;
+}
+
+QDropboxRequest* QDropboxRequest::run(const Continuation& continuation) {
+    QObject* receiver = continuation.receiver;
+    const QByteArray& method = m_result.isOk() ? continuation.onSucceeded : continuation.onFailed;
+    if (receiver == 0 || method.isEmpty()) {
+        return 0;
+    }
+
+    // a slot returning a handle chains the call it started, any other slot is invoked as is
+    QDropboxRequest* returned = 0;
+    if (m_result.isOk()) {
+        if (!QMetaObject::invokeMethod(receiver, method.constData(), Qt::DirectConnection,
+                Q_RETURN_ARG(QDropboxRequest*, returned), Q_ARG(QVariant, m_result.value))) {
+            QMetaObject::invokeMethod(receiver, method.constData(), Qt::DirectConnection, Q_ARG(QVariant, m_result.value));
+        }
+    } else {
+        if (!QMetaObject::invokeMethod(receiver, method.constData(), Qt::DirectConnection,
+                Q_RETURN_ARG(QDropboxRequest*, returned), Q_ARG(QNetworkReply::NetworkError, m_result.error), Q_ARG(QString, m_result.errorString))) {
+            QMetaObject::invokeMethod(receiver, method.constData(), Qt::DirectConnection,
+                    Q_ARG(QNetworkReply::NetworkError, m_result.error), Q_ARG(QString, m_result.errorString));
+        }
+    }
+    return returned;
+}
+
+void QDropboxRequest::onSourceFinished() {
+    QDropboxRequest* source = qobject_cast<QDropboxRequest*>(QObject::sender());
+    if (source != 0) {
+        settleWith(source->getResult());
+    }
+}
+
+void QDropboxRequest::settleWith(const QDropboxResult& result) {
+    m_result = result;
+    if (m_cancelled) {
+        reject(QNetworkReply::OperationCanceledError, "Request cancelled");
+    }
+    finish();
+    deleteLater();
+}
+
+QByteArray QDropboxRequest::methodName(const char* slot) {
+    // SLOT() prefixes the signature with a code, only the method name is kept for QMetaObject::invokeMethod
+    if (slot == 0 || *slot == 0) {
+        return QByteArray();
+    }
+    QByteArray name(slot + 1);
+    return name.left(name.indexOf('('));
+}
+
+void QDropboxRequest::cancel() {
+    if (m_cancelled) {
+        return;
+    }
+    m_cancelled = true;
+    emit cancelled();
+    if (m_pReply != 0 && !m_pReply->isFinished()) {
+        m_pReply->abort();
+    }
+}
+
+void QDropboxRequest::touch() {
+    m_lastActivity = QDateTime::currentMSecsSinceEpoch();
+}
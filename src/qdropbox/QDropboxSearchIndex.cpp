@@ -0,0 +1,215 @@
+/*
+ * QDropboxSearchIndex.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#include "../../include/qdropbox/QDropboxSearchIndex.hpp"
+#include <QRegExp>
+
+QDropboxSearchIndex::QDropboxSearchIndex(QObject* parent) : QObject(parent) {}
+
+QDropboxSearchIndex::~QDropboxSearchIndex() {}
+
+void QDropboxSearchIndex::attach(QDropbox* dropbox) {
+    bool res = QObject::connect(dropbox, SIGNAL(listFolderLoaded(const QString&, QList<QDropboxFile*>&, const QString&, const bool&)),
+            this, SLOT(onListFolderLoaded(const QString&, QList<QDropboxFile*>&, const QString&, const bool&)));
+    Q_ASSERT(res);
+    res = QObject::connect(dropbox, SIGNAL(listFolderPageLoaded(const QString&, QList<QDropboxFile*>&, const QString&, const bool&)),
+            this, SLOT(onListFolderLoaded(const QString&, QList<QDropboxFile*>&, const QString&, const bool&)));
+    Q_ASSERT(res);
+    res = QObject::connect(dropbox, SIGNAL(listFolderContinueLoaded(QList<QDropboxFile*>&, const QString&, const QString&, const bool&)),
+            this, SLOT(onListFolderContinueLoaded(QList<QDropboxFile*>&, const QString&, const QString&, const bool&)));
+    Q_ASSERT(res);
+    Q_UNUSED(res);
+}
+
+void QDropboxSearchIndex::attach(QDropboxDeltaSync* deltaSync) {
+    bool res = QObject::connect(deltaSync, SIGNAL(added(const QList<QDropboxFile*>&)), this, SLOT(add(const QList<QDropboxFile*>&)));
+    Q_ASSERT(res);
+    res = QObject::connect(deltaSync, SIGNAL(modified(const QList<QDropboxFile*>&)), this, SLOT(add(const QList<QDropboxFile*>&)));
+    Q_ASSERT(res);
+    res = QObject::connect(deltaSync, SIGNAL(deleted(const QStringList&)), this, SLOT(remove(const QStringList&)));
+    Q_ASSERT(res);
+    Q_UNUSED(res);
+}
+
+int QDropboxSearchIndex::size() const {
+    return m_entries.size();
+}
+
+bool QDropboxSearchIndex::contains(const QString& path) const {
+    return m_entries.contains(path.toLower());
+}
+
+QDropboxIndexEntry QDropboxSearchIndex::entry(const QString& path) const {
+    return m_entries.value(path.toLower());
+}
+
+QList<QDropboxIndexEntry> QDropboxSearchIndex::findByPrefix(const QString& prefix, const int& limit) const {
+    QList<QDropboxIndexEntry> result;
+    QString word = prefix.trimmed().toLower();
+    if (word.isEmpty()) {
+        return result;
+    }
+
+    QSet<QString> seen;
+    QMap<QString, QString>::const_iterator it = m_words.lowerBound(word);
+    while (it != m_words.constEnd() && it.key().startsWith(word) && result.size() != limit) {
+        if (!seen.contains(it.value())) {
+            seen.insert(it.value());
+            result.append(m_entries.value(it.value()));
+        }
+        ++it;
+    }
+    return result;
+}
+
+QList<QDropboxIndexEntry> QDropboxSearchIndex::findByExtension(const QString& extension, const int& limit) const {
+    QList<QDropboxIndexEntry> result;
+    QString ext = extension.toLower();
+    if (ext.startsWith(".")) {
+        ext.remove(0, 1);
+    }
+
+    const QSet<QString> paths = m_extensions.value(ext);
+    foreach(QString path, paths) {
+        if (result.size() == limit) {
+            break;
+        }
+        result.append(m_entries.value(path));
+    }
+    return result;
+}
+
+QList<QDropboxIndexEntry> QDropboxSearchIndex::findUnder(const QString& path, const bool& recursive, const int& limit) const {
+    QList<QDropboxIndexEntry> result;
+    QString prefix = path.toLower();
+    if (!prefix.endsWith("/")) {
+        prefix.append("/");
+    }
+
+    QMap<QString, QDropboxIndexEntry>::const_iterator it = m_entries.lowerBound(prefix);
+    while (it != m_entries.constEnd() && it.key().startsWith(prefix) && result.size() != limit) {
+        if (recursive || it.key().indexOf('/', prefix.size()) == -1) {
+            result.append(it.value());
+        }
+        ++it;
+    }
+    return result;
+}
+
+void QDropboxSearchIndex::add(const QList<QDropboxFile*>& files) {
+    foreach(QDropboxFile* file, files) {
+        if (file->getTag().compare(DELETED_TAG) == 0) {
+            remove(QStringList() << file->getPathLower());
+        } else {
+            QDropboxIndexEntry e;
+            e.fromFile(*file);
+            insert(e);
+        }
+    }
+}
+
+void QDropboxSearchIndex::remove(const QStringList& paths) {
+    foreach(QString path, paths) {
+        QString pathLower = path.toLower();
+        erase(pathLower);
+
+        QString prefix = pathLower + "/";
+        QStringList subtree;
+        QMap<QString, QDropboxIndexEntry>::const_iterator it = m_entries.lowerBound(prefix);
+        while (it != m_entries.constEnd() && it.key().startsWith(prefix)) {
+            subtree.append(it.key());
+            ++it;
+        }
+        foreach(QString p, subtree) {
+            erase(p);
+        }
+    }
+}
+
+void QDropboxSearchIndex::clear() {
+    m_entries.clear();
+    m_words.clear();
+    m_extensions.clear();
+}
+
+void QDropboxSearchIndex::onListFolderLoaded(const QString& path, QList<QDropboxFile*>& files, const QString& cursor, const bool& hasMore) {
+    add(files);
+    Q_UNUSED(path);
+    Q_UNUSED(cursor);
+    Q_UNUSED(hasMore);
+}
+
+void QDropboxSearchIndex::onListFolderContinueLoaded(QList<QDropboxFile*>& files, const QString& prevCursor, const QString& cursor, const bool& hasMore) {
+    add(files);
+    Q_UNUSED(prevCursor);
+    Q_UNUSED(cursor);
+    Q_UNUSED(hasMore);
+}
+
+void QDropboxSearchIndex::insert(const QDropboxIndexEntry& entry) {
+    if (entry.pathLower.isEmpty()) {
+        return;
+    }
+
+    erase(entry.pathLower);
+    m_entries.insert(entry.pathLower, entry);
+
+    foreach(QString word, words(entry.name)) {
+        m_words.insert(wordKey(word, entry.pathLower), entry.pathLower);
+    }
+
+    if (!entry.isDir()) {
+        QString ext = extension(entry.name);
+        if (!ext.isEmpty()) {
+            m_extensions[ext].insert(entry.pathLower);
+        }
+    }
+}
+
+void QDropboxSearchIndex::erase(const QString& pathLower) {
+    if (!m_entries.contains(pathLower)) {
+        return;
+    }
+
+    QDropboxIndexEntry entry = m_entries.take(pathLower);
+    foreach(QString word, words(entry.name)) {
+        m_words.remove(wordKey(word, pathLower));
+    }
+
+    QString ext = extension(entry.name);
+    if (m_extensions.contains(ext)) {
+        QSet<QString>& bucket = m_extensions[ext];
+        bucket.remove(pathLower);
+        if (bucket.isEmpty()) {
+            m_extensions.remove(ext);
+        }
+    }
+}
+
+QStringList QDropboxSearchIndex::words(const QString& name) {
+    static const QRegExp separators("[\\s_\\-\\.,()\\[\\]]+");
+
+    QString lower = name.toLower();
+    QStringList list = lower.split(separators, QString::SkipEmptyParts);
+    if (!list.contains(lower)) {
+        list.prepend(lower);
+    }
+    list.removeDuplicates();
+    return list;
+}
+
+QString QDropboxSearchIndex::extension(const QString& name) {
+    int index = name.lastIndexOf('.');
+    if (index <= 0 || index == name.size() - 1) {
+        return "";
+    }
+    return name.mid(index + 1).toLower();
+}
+
+QString QDropboxSearchIndex::wordKey(const QString& word, const QString& pathLower) {
+    return QString(word).append(QChar(0)).append(pathLower);
+}
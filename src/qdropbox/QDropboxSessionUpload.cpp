@@ -0,0 +1,112 @@
+/*
+ * QDropboxSessionUpload.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#include "../../include/qdropbox/QDropboxSessionUpload.hpp"
+#include <QFileInfo>
+
+Logger QDropboxSessionUpload::logger = Logger::getLogger("QDropboxSessionUpload");
+
+#define CHUNK_SIZE 8388608 // 8 MB, a multiple of the 4 MB content hash block
+
+QDropboxSessionUpload::QDropboxSessionUpload(QDropbox* dropbox, const QString& localPath, const QString& remotePath, const QString& mode, QObject* parent) : QObject(parent),
+        m_pDropbox(dropbox), m_file(localPath), m_localPath(localPath), m_remotePath(remotePath), m_mode(mode),
+        m_chunkSize(CHUNK_SIZE), m_offset(0), m_sending(0), m_pRequest(0) {}
+
+QDropboxSessionUpload::~QDropboxSessionUpload() {}
+
+const QString& QDropboxSessionUpload::getLocalPath() const { return m_localPath; }
+
+const QString& QDropboxSessionUpload::getRemotePath() const { return m_remotePath; }
+
+const qint64& QDropboxSessionUpload::getChunkSize() const { return m_chunkSize; }
+QDropboxSessionUpload& QDropboxSessionUpload::setChunkSize(const qint64& chunkSize) {
+    m_chunkSize = chunkSize;
+    return *this;
+}
+
+bool QDropboxSessionUpload::start() {
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        logger.error("Cannot open file: " + m_localPath);
+        return false;
+    }
+
+    if (m_file.size() <= m_chunkSize) {
+        // a session needs a non empty chunk to start and another one to finish
+        m_file.close();
+        m_pRequest = m_pDropbox->upload(new QFile(m_localPath), m_remotePath, m_mode, false);
+        m_pRequest->then(this, SLOT(onFinished(const QVariant&)), SLOT(onFailed(QNetworkReply::NetworkError, const QString&)));
+        return true;
+    }
+
+    m_sessionId = "";
+    m_offset = 0;
+    next();
+    return true;
+}
+
+void QDropboxSessionUpload::cancel() {
+    if (m_pRequest != 0) {
+        m_pRequest->cancel();
+    }
+}
+
+void QDropboxSessionUpload::onStarted(const QVariant& value) {
+    m_pRequest = 0;
+    m_sessionId = value.toMap().value("session_id").toString();
+    m_offset += m_sending;
+    emit progress(m_offset, m_file.size());
+    next();
+}
+
+void QDropboxSessionUpload::onAppended(const QVariant& value) {
+    m_pRequest = 0;
+    m_offset += m_sending;
+    emit progress(m_offset, m_file.size());
+    next();
+    Q_UNUSED(value);
+}
+
+void QDropboxSessionUpload::onFinished(const QVariant& value) {
+    m_pRequest = 0;
+    qint64 total = QFileInfo(m_localPath).size();
+    m_file.close();
+    emit progress(total, total);
+    emit finished(value);
+}
+
+void QDropboxSessionUpload::onFailed(QNetworkReply::NetworkError e, const QString& errorString) {
+    m_pRequest = 0;
+    fail(errorString);
+    Q_UNUSED(e);
+}
+
+void QDropboxSessionUpload::next() {
+    QByteArray data = m_file.read(m_chunkSize);
+    if (data.isEmpty()) {
+        fail("Cannot read file: " + m_localPath);
+        return;
+    }
+
+    m_sending = data.size();
+    const char* slot = SLOT(onAppended(const QVariant&));
+    if (m_sessionId.isEmpty()) {
+        m_pRequest = m_pDropbox->uploadSessionStart(m_remotePath, data);
+        slot = SLOT(onStarted(const QVariant&));
+    } else if (m_offset + data.size() >= m_file.size()) {
+        m_pRequest = m_pDropbox->uploadSessionFinish(m_sessionId, data, m_offset, m_remotePath, m_mode);
+        slot = SLOT(onFinished(const QVariant&));
+    } else {
+        m_pRequest = m_pDropbox->uploadSessionAppend(m_sessionId, data, m_offset);
+    }
+    m_pRequest->then(this, slot, SLOT(onFailed(QNetworkReply::NetworkError, const QString&)));
+}
+
+void QDropboxSessionUpload::fail(const QString& reason) {
+    m_file.close();
+    logger.error("Upload of " + m_localPath + " failed: " + reason);
+    emit failed(reason);
+}
@@ -0,0 +1,151 @@
+/*
+ * QDropboxShardedListing.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#include "../../include/qdropbox/QDropboxShardedListing.hpp"
+
+Logger QDropboxShardedListing::logger = Logger::getLogger("QDropboxShardedListing");
+
+#define DEFAULT_CONCURRENCY 4
+
+QDropboxShardedListing::QDropboxShardedListing(QDropbox* dropbox, QObject* parent) : QObject(parent),
+        m_pDropbox(dropbox), m_path(""), m_includeMediaInfo(false), m_concurrency(DEFAULT_CONCURRENCY),
+        m_running(false), m_topLevelListed(false) {
+
+    bool res = QObject::connect(m_pDropbox, SIGNAL(listFolderPageLoaded(const QString&, QList<QDropboxFile*>&, const QString&, const bool&)),
+            this, SLOT(onListFolderPageLoaded(const QString&, QList<QDropboxFile*>&, const QString&, const bool&)));
+    Q_ASSERT(res);
+    res = QObject::connect(m_pDropbox, SIGNAL(listFolderPagingFinished(const QString&, const QString&)),
+            this, SLOT(onListFolderPagingFinished(const QString&, const QString&)));
+    Q_ASSERT(res);
+    res = QObject::connect(m_pDropbox, SIGNAL(listFolderPagingFailed(const QString&, QNetworkReply::NetworkError, const QString&)),
+            this, SLOT(onListFolderPagingFailed(const QString&, QNetworkReply::NetworkError, const QString&)));
+    Q_ASSERT(res);
+    Q_UNUSED(res);
+}
+
+QDropboxShardedListing::~QDropboxShardedListing() {}
+
+const int& QDropboxShardedListing::getConcurrency() const { return m_concurrency; }
+QDropboxShardedListing& QDropboxShardedListing::setConcurrency(const int& concurrency) {
+    m_concurrency = qMax(1, concurrency);
+    return *this;
+}
+
+const QString& QDropboxShardedListing::getPath() const { return m_path; }
+
+const QList<QDropboxFile*>& QDropboxShardedListing::getFiles() const { return m_files; }
+
+const QMap<QString, QString>& QDropboxShardedListing::getCursors() const { return m_cursors; }
+
+bool QDropboxShardedListing::isRunning() const {
+    return m_running;
+}
+
+void QDropboxShardedListing::start(const QString& path, const bool& includeMediaInfo) {
+    if (m_running) {
+        logger.warn("Listing is already running: " + m_path);
+        return;
+    }
+
+    m_path = path;
+    m_includeMediaInfo = includeMediaInfo;
+    m_running = true;
+    m_topLevelListed = false;
+    m_pendingShards.clear();
+    m_runningShards.clear();
+    m_pagingIds.clear();
+    m_files.clear();
+    m_cursors.clear();
+
+    list(m_path, false);
+}
+
+void QDropboxShardedListing::onListFolderPageLoaded(const QString& path, QList<QDropboxFile*>& files, const QString& cursor, const bool& hasMore) {
+    if (!m_running) {
+        return;
+    }
+
+    QList<QDropboxFile*> page;
+    if (!m_topLevelListed && path.compare(m_path) == 0) {
+        foreach(QDropboxFile* file, files) {
+            if (file->isDir()) {
+                m_pendingShards.append(file->getPathLower());
+            }
+            page.append(file);
+        }
+        m_files.append(page);
+        emit pageLoaded(m_path, page);
+        next();
+    } else if (m_runningShards.contains(path)) {
+        foreach(QDropboxFile* file, files) {
+            // recursive listing repeats the shard root which the top level already delivered
+            if (file->getPathLower().compare(path) != 0) {
+                page.append(file);
+            }
+        }
+        m_files.append(page);
+        emit pageLoaded(path, page);
+    }
+    Q_UNUSED(cursor);
+    Q_UNUSED(hasMore);
+}
+
+void QDropboxShardedListing::onListFolderPagingFinished(const QString& path, const QString& cursor) {
+    if (!m_running) {
+        return;
+    }
+
+    if (!m_topLevelListed && path.compare(m_path) == 0) {
+        m_topLevelListed = true;
+        m_cursors.insert(m_path, cursor);
+    } else if (m_runningShards.remove(path)) {
+        m_cursors.insert(path, cursor);
+    } else {
+        return;
+    }
+    m_pagingIds.remove(path);
+
+    next();
+}
+
+void QDropboxShardedListing::onListFolderPagingFailed(const QString& path, QNetworkReply::NetworkError e, const QString& errorString) {
+    if (!m_running || !m_pagingIds.contains(path)) {
+        return;
+    }
+
+    // without one shard the snapshot is incomplete, the others are not worth finishing
+    m_pagingIds.remove(path);
+    foreach(int pagingId, m_pagingIds.values()) {
+        m_pDropbox->cancelListFolderPaging(pagingId);
+    }
+    m_pagingIds.clear();
+    m_pendingShards.clear();
+    m_runningShards.clear();
+    m_running = false;
+
+    logger.error("Listing of " + path + " failed: " + errorString);
+    emit failed(path, e, errorString);
+}
+
+void QDropboxShardedListing::list(const QString& path, const bool& recursive) {
+    QDropboxRequest* request = m_pDropbox->listFolderPaged(path, m_includeMediaInfo, recursive);
+    m_pagingIds.insert(path, request->getContext().pagingId);
+}
+
+void QDropboxShardedListing::next() {
+    while (m_runningShards.size() < m_concurrency && m_pendingShards.size()) {
+        QString shard = m_pendingShards.takeFirst();
+        m_runningShards.insert(shard);
+        list(shard, true);
+    }
+
+    if (m_topLevelListed && m_runningShards.isEmpty() && m_pendingShards.isEmpty()) {
+        m_running = false;
+        logger.info("Listed " + QString::number(m_files.size()) + " entries in " + QString::number(m_cursors.size()) + " shards");
+        emit finished(m_files, m_cursors);
+    }
+}
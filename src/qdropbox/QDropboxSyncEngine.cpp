@@ -0,0 +1,782 @@
+/*
+ * QDropboxSyncEngine.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#include "../../include/qdropbox/QDropboxSyncEngine.hpp"
+#include "../../include/qdropbox/QDropboxCommon.hpp"
+#include "../../include/qdropbox/QDropboxJobTracker.hpp"
+#include "../../include/qdropbox/QDropboxAtomicFile.hpp"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDate>
+#include <QDateTime>
+#include <QThreadPool>
+
+Logger QDropboxSyncEngine::logger = Logger::getLogger("QDropboxSyncEngine");
+
+#define CONCURRENCY 4
+#define BATCH_SIZE 1000 // max allowed by Dropbox
+#define STATE_VERSION 1
+#define SAVE_DELAY 2000
+
+QDropboxSyncEngine::QDropboxSyncEngine(QDropbox* dropbox, const QString& localPath, const QString& remotePath, const QString& statePath, QObject* parent) : QObject(parent),
+        m_pDropbox(dropbox), m_localPath(QDir(localPath).absolutePath()), m_remotePath(remotePath), m_statePath(statePath),
+        m_concurrency(CONCURRENCY), m_state(Idle), m_listing(false), m_relisted(false), m_done(0), m_total(0), m_failures(0) {
+    // the root of a Dropbox is an empty path
+    while (m_remotePath.endsWith("/")) {
+        m_remotePath.chop(1);
+    }
+
+    m_saveTimer.setSingleShot(true);
+    m_saveTimer.setInterval(SAVE_DELAY);
+
+    bool res = QObject::connect(&m_saveTimer, SIGNAL(timeout()), this, SLOT(save()));
+    Q_ASSERT(res);
+    res = QObject::connect(m_pDropbox, SIGNAL(listFolderLoaded(const QString&, QList<QDropboxFile*>&, const QString&, const bool&)),
+            this, SLOT(onListFolderLoaded(const QString&, QList<QDropboxFile*>&, const QString&, const bool&)));
+    Q_ASSERT(res);
+    res = QObject::connect(m_pDropbox, SIGNAL(listFolderContinueLoaded(QList<QDropboxFile*>&, const QString&, const QString&, const bool&)),
+            this, SLOT(onListFolderContinueLoaded(QList<QDropboxFile*>&, const QString&, const QString&, const bool&)));
+    Q_ASSERT(res);
+    res = QObject::connect(m_pDropbox->getJobTracker(), SIGNAL(finished(const AsyncJobStatus&)), this, SLOT(onJobFinished(const AsyncJobStatus&)));
+    Q_ASSERT(res);
+    Q_UNUSED(res);
+
+    load();
+}
+
+QDropboxSyncEngine::~QDropboxSyncEngine() {
+    if (m_saveTimer.isActive()) {
+        save();
+    }
+}
+
+const QString& QDropboxSyncEngine::getLocalPath() const { return m_localPath; }
+
+const QString& QDropboxSyncEngine::getRemotePath() const { return m_remotePath; }
+
+const QString& QDropboxSyncEngine::getStatePath() const { return m_statePath; }
+
+const int& QDropboxSyncEngine::getConcurrency() const { return m_concurrency; }
+QDropboxSyncEngine& QDropboxSyncEngine::setConcurrency(const int& concurrency) {
+    m_concurrency = qMax(1, concurrency);
+    return *this;
+}
+
+bool QDropboxSyncEngine::isRunning() const {
+    return m_state != Idle;
+}
+
+void QDropboxSyncEngine::sync() {
+    if (m_state != Idle) {
+        return;
+    }
+
+    m_state = Scanning;
+    m_local.clear();
+    m_moves.clear();
+    m_deletes.clear();
+    m_queue.clear();
+    m_done = 0;
+    m_total = 0;
+    m_failures = 0;
+    m_relisted = false;
+    m_jobId = "";
+    m_batchMoves.clear();
+    m_batchDeletes.clear();
+
+    QDir().mkpath(m_localPath);
+    QHash<QString, LocalEntry> known;
+    QHash<QString, SyncEntry>::const_iterator it = m_base.constBegin();
+    for (; it != m_base.constEnd(); ++it) {
+        LocalEntry entry;
+        entry.path = it.value().path;
+        entry.folder = it.value().folder;
+        entry.size = it.value().size;
+        entry.modified = it.value().modified;
+        entry.contentHash = it.value().contentHash;
+        known.insert(it.key(), entry);
+    }
+
+    m_scanners = QDropboxLocalScanner::split(m_localPath, known);
+    foreach(QDropboxLocalScanner* scanner, m_scanners) {
+        bool res = QObject::connect(scanner, SIGNAL(scanned()), this, SLOT(onScanned()));
+        Q_ASSERT(res);
+        Q_UNUSED(res);
+        QThreadPool::globalInstance()->start(scanner);
+    }
+
+    list();
+}
+
+void QDropboxSyncEngine::stop() {
+    if (m_state == Idle) {
+        return;
+    }
+
+    m_state = Idle;
+    m_listing = false;
+    m_scanners.clear();
+    m_queue.clear();
+    foreach(QDropboxRequest* request, m_transfers.keys()) {
+        request->cancel();
+    }
+    foreach(QDropboxSessionUpload* upload, m_uploads.keys()) {
+        upload->cancel();
+    }
+    save();
+}
+
+void QDropboxSyncEngine::list() {
+    m_listing = true;
+    QDropboxRequest* request = 0;
+    if (m_cursor.isEmpty()) {
+        m_remote.clear();
+        request = m_pDropbox->listFolder(m_remotePath, false, true);
+    } else {
+        request = m_pDropbox->listFolderContinue(m_cursor);
+    }
+
+    bool res = QObject::connect(request, SIGNAL(failed(QNetworkReply::NetworkError, const QString&)),
+            this, SLOT(onListingFailed(QNetworkReply::NetworkError, const QString&)));
+    Q_ASSERT(res);
+    Q_UNUSED(res);
+}
+
+void QDropboxSyncEngine::onScanned() {
+    QDropboxLocalScanner* scanner = qobject_cast<QDropboxLocalScanner*>(QObject::sender());
+    scanner->deleteLater();
+    if (!m_scanners.removeOne(scanner)) {
+        // left over from a stopped sync
+        return;
+    }
+
+    foreach(LocalEntry local, scanner->getEntries()) {
+        SyncEntry entry;
+        entry.path = local.path;
+        entry.folder = local.folder;
+        entry.size = local.size;
+        entry.modified = local.modified;
+        entry.contentHash = local.contentHash;
+        m_local.insert(local.path.toLower(), entry);
+    }
+
+    if (m_scanners.isEmpty() && !m_listing && m_state == Scanning) {
+        reconcile();
+    }
+}
+
+void QDropboxSyncEngine::onListFolderLoaded(const QString& path, QList<QDropboxFile*>& files, const QString& cursor, const bool& hasMore) {
+    if (!m_listing || !m_cursor.isEmpty() || path.compare(m_remotePath) != 0) {
+        return;
+    }
+    onListFolderContinueLoaded(files, m_cursor, cursor, hasMore);
+}
+
+void QDropboxSyncEngine::onListFolderContinueLoaded(QList<QDropboxFile*>& files, const QString& prevCursor, const QString& cursor, const bool& hasMore) {
+    if (!m_listing || prevCursor.compare(m_cursor) != 0) {
+        return;
+    }
+
+    QString root = m_remotePath.toLower() + "/";
+    foreach(QDropboxFile* file, files) {
+        QString pathLower = file->getPathLower();
+        if (pathLower.startsWith(root)) {
+            QString key = pathLower.mid(root.size());
+            if (file->getTag().compare(DELETED_TAG) == 0) {
+                removeTree(m_remote, key);
+            } else {
+                SyncEntry entry;
+                entry.path = file->getPathDisplay().mid(root.size());
+                entry.folder = file->getTag().compare(FOLDER_TAG) == 0;
+                entry.size = file->getSize();
+                entry.contentHash = file->getContentHash();
+                entry.rev = file->getRev();
+                m_remote.insert(key, entry);
+            }
+        }
+    }
+
+    // the index and the cursor always move together, see save()
+    m_cursor = cursor;
+    if (hasMore) {
+        list();
+        return;
+    }
+
+    m_listing = false;
+    if (m_scanners.isEmpty() && m_state == Scanning) {
+        reconcile();
+    }
+}
+
+void QDropboxSyncEngine::onListingFailed(QNetworkReply::NetworkError e, const QString& errorString) {
+    if (!m_listing) {
+        return;
+    }
+
+    if (!m_cursor.isEmpty() && !m_relisted) {
+        // an expired cursor has to be replaced by a full listing
+        logger.warn("Cannot continue listing, listing again: " + errorString);
+        m_relisted = true;
+        m_cursor = "";
+        list();
+        return;
+    }
+
+    m_listing = false;
+    m_state = Idle;
+    emit failed(errorString);
+    Q_UNUSED(e);
+}
+
+void QDropboxSyncEngine::reconcile() {
+    QSet<QString> keys = m_local.keys().toSet();
+    keys.unite(m_remote.keys().toSet());
+    keys.unite(m_base.keys().toSet());
+    QStringList sorted = keys.toList();
+    qSort(sorted);
+
+    QList<QPair<QString, QString> > renames;
+    QStringList localFolders;
+    QStringList localDeletes;
+    QStringList remoteDeletes;
+    QList<Operation> uploads;
+    QList<Operation> downloads;
+    QList<Operation> remoteFolders;
+    QSet<QString> replaced;
+
+    foreach(QString key, sorted) {
+        bool hasLocal = m_local.contains(key);
+        bool hasRemote = m_remote.contains(key);
+        bool hasBase = m_base.contains(key);
+        SyncEntry local = m_local.value(key);
+        SyncEntry remote = m_remote.value(key);
+        SyncEntry base = m_base.value(key);
+
+        if (hasLocal && hasRemote && same(local, remote)) {
+            local.rev = remote.rev;
+            m_base.insert(key, local);
+            continue;
+        }
+        if (!hasLocal && !hasRemote) {
+            m_base.remove(key);
+            continue;
+        }
+
+        bool localChanged = hasBase ? !hasLocal || !same(local, base) : hasLocal;
+        bool remoteChanged = hasBase ? !hasRemote || !same(remote, base) : hasRemote;
+        bool push = false;
+        bool pull = false;
+        if (!remoteChanged) {
+            if (!hasLocal || (hasRemote && remote.folder != local.folder)) {
+                remoteDeletes.append(key);
+            }
+            if (hasLocal && hasRemote) {
+                replaced.insert(key);
+            }
+            push = hasLocal;
+        } else if (!localChanged) {
+            if (!hasRemote || (hasLocal && local.folder != remote.folder)) {
+                localDeletes.append(key);
+            }
+            if (hasLocal && hasRemote) {
+                replaced.insert(key);
+            }
+            pull = hasRemote;
+        } else if (!hasLocal || !hasRemote) {
+            push = hasLocal;
+            pull = hasRemote;
+        } else if (!local.folder) {
+            // changed on both sides, the local version is kept next to the remote one
+            QString copy = conflictedCopy(local.path);
+            logger.info("Conflict: " + local.path + ", local version kept as " + copy);
+            renames.append(qMakePair(local.path, copy));
+            local.path = copy;
+            key = copy.toLower();
+            push = true;
+            pull = true;
+        } else {
+            // a local folder replaced a remote file, the remote file gets out of the way
+            Move move;
+            move.fromKey = key;
+            move.toPath = conflictedCopy(remote.path);
+            move.toKey = move.toPath.toLower();
+            m_moves.append(move);
+            push = true;
+        }
+
+        if (push) {
+            Operation operation;
+            operation.kind = local.folder ? Operation::CreateFolder : Operation::Upload;
+            operation.key = key;
+            operation.mode = hasRemote && !remote.folder && key.compare(remote.path.toLower()) == 0 ? "overwrite" : "add";
+            operation.entry = local;
+            (local.folder ? remoteFolders : uploads).append(operation);
+        }
+        if (pull) {
+            key = remote.path.toLower();
+            if (remote.folder) {
+                localFolders.append(key);
+            } else {
+                Operation operation;
+                operation.kind = Operation::Download;
+                operation.key = key;
+                operation.entry = remote;
+                downloads.append(operation);
+            }
+        }
+    }
+
+    // a file that vanished at one path and showed up with the same content at another was moved
+    QHash<QString, QString> vanishedRemotely;
+    QHash<QString, QString> vanishedLocally;
+    foreach(QString key, remoteDeletes) {
+        SyncEntry base = m_base.value(key);
+        if (!base.folder && !base.contentHash.isEmpty()) {
+            vanishedLocally.insert(base.contentHash, vanishedLocally.contains(base.contentHash) ? QString() : key);
+        }
+    }
+    foreach(QString key, localDeletes) {
+        SyncEntry base = m_base.value(key);
+        if (!base.folder && !base.contentHash.isEmpty()) {
+            vanishedRemotely.insert(base.contentHash, vanishedRemotely.contains(base.contentHash) ? QString() : key);
+        }
+    }
+
+    QMutableListIterator<Operation> up(uploads);
+    while (up.hasNext()) {
+        Operation& operation = up.next();
+        QString from = vanishedLocally.value(operation.entry.contentHash);
+        if (!from.isEmpty() && operation.mode.compare("add") == 0 && !m_base.contains(operation.key)) {
+            Move move;
+            move.fromKey = from;
+            move.toKey = operation.key;
+            move.toPath = operation.entry.path;
+            move.entry = operation.entry;
+            move.entry.rev = m_base.value(from).rev;
+            m_moves.append(move);
+            remoteDeletes.removeOne(from);
+            vanishedLocally.remove(operation.entry.contentHash);
+            up.remove();
+        }
+    }
+
+    QMutableListIterator<Operation> down(downloads);
+    while (down.hasNext()) {
+        Operation& operation = down.next();
+        QString from = vanishedRemotely.value(operation.entry.contentHash);
+        if (!from.isEmpty() && !m_base.contains(operation.key) && !m_local.contains(operation.key)) {
+            renames.append(qMakePair(m_local.value(from).path, operation.entry.path));
+            localDeletes.removeOne(from);
+            vanishedRemotely.remove(operation.entry.contentHash);
+            down.remove();
+        }
+    }
+
+    // folders holding transferred files are created with them, folders holding anything that stays are not deleted
+    QSet<QString> implied;
+    foreach(Operation operation, uploads) {
+        addAncestors(implied, operation.key);
+    }
+    foreach(Operation operation, downloads) {
+        addAncestors(implied, operation.key);
+    }
+    foreach(Move move, m_moves) {
+        addAncestors(implied, move.toKey);
+    }
+    QSet<QString> kept = implied;
+    foreach(QString key, localFolders) {
+        addAncestors(kept, key);
+    }
+    foreach(Operation operation, remoteFolders) {
+        addAncestors(kept, operation.key);
+    }
+
+    QSet<QString> deleted;
+    foreach(QString key, remoteDeletes) {
+        if ((replaced.contains(key) || !kept.contains(key)) && !hasAncestor(deleted, key)) {
+            m_deletes.append(key);
+            deleted.insert(key);
+        }
+    }
+    deleted.clear();
+    QStringList removals;
+    foreach(QString key, localDeletes) {
+        if ((replaced.contains(key) || !kept.contains(key)) && !hasAncestor(deleted, key)) {
+            removals.append(key);
+            deleted.insert(key);
+        }
+    }
+
+    foreach(Operation operation, remoteFolders) {
+        if (!implied.contains(operation.key)) {
+            m_queue.append(operation);
+        }
+    }
+    m_queue.append(uploads);
+    m_queue.append(downloads);
+
+    m_total = renames.size() + localFolders.size() + removals.size() + m_moves.size() + m_deletes.size() + m_queue.size();
+    emit planned(m_total);
+    logger.info("Planned " + QString::number(m_total) + " operations for " + m_localPath);
+
+    // local changes are cheap and may make room for incoming files, so they go first
+    typedef QPair<QString, QString> Rename;
+    foreach(Rename rename, renames) {
+        QString to = localFilePath(rename.second);
+        QDir().mkpath(QFileInfo(to).absolutePath());
+        bool ok = QFile::rename(localFilePath(rename.first), to);
+        if (ok) {
+            QString key = rename.second.toLower();
+            QFileInfo info(to);
+            SyncEntry entry = m_remote.value(key, m_local.value(rename.first.toLower()));
+            entry.path = rename.second;
+            entry.size = info.size();
+            entry.modified = info.lastModified().toMSecsSinceEpoch();
+            m_base.remove(rename.first.toLower());
+            if (m_remote.contains(key)) {
+                m_base.insert(key, entry);
+            }
+        }
+        done(ok);
+    }
+    foreach(QString key, removals) {
+        bool ok = removeLocal(localFilePath(m_local.value(key).path));
+        if (ok) {
+            removeTree(m_base, key);
+        }
+        done(ok);
+    }
+    foreach(QString key, localFolders) {
+        bool ok = QDir().mkpath(localFilePath(m_remote.value(key).path));
+        if (ok) {
+            m_base.insert(key, m_remote.value(key));
+        }
+        done(ok);
+    }
+
+    m_state = Moving;
+    nextBatch();
+}
+
+void QDropboxSyncEngine::nextBatch() {
+    QDropboxRequest* request = 0;
+    if (m_state == Moving && !m_moves.isEmpty()) {
+        // moves go first, they may leave a folder empty that is deleted afterwards
+        QList<MoveEntry> entries;
+        m_batchMoves = m_moves.mid(0, BATCH_SIZE);
+        m_moves = m_moves.mid(m_batchMoves.size());
+        foreach(Move move, m_batchMoves) {
+            entries.append(MoveEntry(remoteFilePath(m_remote.value(move.fromKey, m_base.value(move.fromKey)).path), remoteFilePath(move.toPath)));
+        }
+        request = m_pDropbox->moveBatch(entries);
+    } else if (m_state != Idle && !m_deletes.isEmpty()) {
+        m_state = Deleting;
+        QStringList paths;
+        m_batchDeletes = m_deletes.mid(0, BATCH_SIZE);
+        m_deletes = m_deletes.mid(m_batchDeletes.size());
+        foreach(QString key, m_batchDeletes) {
+            paths.append(remoteFilePath(m_remote.value(key, m_base.value(key)).path));
+        }
+        request = m_pDropbox->deleteBatch(paths);
+    } else if (m_state != Idle) {
+        m_state = Transferring;
+        pump();
+        return;
+    } else {
+        return;
+    }
+
+    request->then(this, SLOT(onBatchLaunched(const QVariant&)), SLOT(onBatchFailed(QNetworkReply::NetworkError, const QString&)));
+}
+
+void QDropboxSyncEngine::onBatchLaunched(const QVariant& value) {
+    QVariantMap map = value.toMap();
+    if (map.value(".tag").toString().compare("async_job_id") == 0) {
+        m_jobId = map.value("async_job_id").toString();
+        return;
+    }
+    batchDone(map.value("entries").toList(), true);
+}
+
+void QDropboxSyncEngine::onBatchFailed(QNetworkReply::NetworkError e, const QString& errorString) {
+    logger.error("Batch failed: " + errorString);
+    batchDone(QVariantList(), false);
+    Q_UNUSED(e);
+}
+
+void QDropboxSyncEngine::onJobFinished(const AsyncJobStatus& status) {
+    if (m_jobId.isEmpty() || status.asyncJobId.compare(m_jobId) != 0) {
+        return;
+    }
+
+    m_jobId = "";
+    batchDone(status.entries, status.status == AsyncJobStatus::Complete);
+}
+
+void QDropboxSyncEngine::batchDone(const QVariantList& entries, const bool& ok) {
+    bool moving = !m_batchMoves.isEmpty();
+    int size = moving ? m_batchMoves.size() : m_batchDeletes.size();
+    for (int i = 0; i < size; i++) {
+        bool succeeded = ok && (i >= entries.size() || entries.at(i).toMap().value(".tag").toString().compare("failure") != 0);
+        if (succeeded && moving) {
+            const Move& move = m_batchMoves.at(i);
+            SyncEntry remote = m_remote.take(move.fromKey);
+            remote.path = move.toPath;
+            m_remote.insert(move.toKey, remote);
+            m_base.remove(move.fromKey);
+            if (!move.entry.path.isEmpty()) {
+                m_base.insert(move.toKey, move.entry);
+            }
+        } else if (succeeded) {
+            removeTree(m_remote, m_batchDeletes.at(i));
+            removeTree(m_base, m_batchDeletes.at(i));
+        }
+        done(succeeded);
+    }
+
+    m_batchMoves.clear();
+    m_batchDeletes.clear();
+    nextBatch();
+}
+
+void QDropboxSyncEngine::pump() {
+    while (m_state == Transferring && !m_queue.isEmpty() && m_transfers.size() + m_uploads.size() < m_concurrency) {
+        if (!start(m_queue.takeFirst())) {
+            done(false);
+        }
+    }
+
+    if (m_state == Transferring && m_queue.isEmpty() && m_transfers.isEmpty() && m_uploads.isEmpty()) {
+        finish();
+    }
+}
+
+bool QDropboxSyncEngine::start(const Operation& operation) {
+    if (operation.kind == Operation::Upload) {
+        QDropboxSessionUpload* upload = new QDropboxSessionUpload(m_pDropbox, localFilePath(operation.entry.path), remoteFilePath(operation.entry.path), operation.mode, this);
+        bool res = QObject::connect(upload, SIGNAL(finished(const QVariant&)), this, SLOT(onUploaded(const QVariant&)));
+        Q_ASSERT(res);
+        res = QObject::connect(upload, SIGNAL(failed(const QString&)), this, SLOT(onUploadFailed(const QString&)));
+        Q_ASSERT(res);
+        Q_UNUSED(res);
+        m_uploads.insert(upload, operation);
+        if (!upload->start()) {
+            m_uploads.remove(upload);
+            upload->deleteLater();
+            return false;
+        }
+        return true;
+    }
+
+    QDropboxRequest* request = 0;
+    if (operation.kind == Operation::Download) {
+        request = m_pDropbox->downloadFile(remoteFilePath(operation.entry.path), localFilePath(operation.entry.path), operation.entry.rev,
+                operation.entry.contentHash);
+    } else {
+        request = m_pDropbox->createFolder(remoteFilePath(operation.entry.path));
+    }
+
+    m_transfers.insert(request, operation);
+    request->then(this, SLOT(onTransferred(const QVariant&)), SLOT(onTransferFailed(QNetworkReply::NetworkError, const QString&)));
+    return true;
+}
+
+void QDropboxSyncEngine::onTransferred(const QVariant& value) {
+    Operation operation = m_transfers.take(qobject_cast<QDropboxRequest*>(QObject::sender()));
+    SyncEntry entry = operation.entry;
+    if (operation.kind == Operation::Download) {
+        QFileInfo info(localFilePath(entry.path));
+        entry.size = info.size();
+        entry.modified = info.lastModified().toMSecsSinceEpoch();
+    } else {
+        m_remote.insert(operation.key, entry);
+    }
+    m_base.insert(operation.key, entry);
+    done(true);
+    pump();
+    Q_UNUSED(value);
+}
+
+void QDropboxSyncEngine::onTransferFailed(QNetworkReply::NetworkError e, const QString& errorString) {
+    Operation operation = m_transfers.take(qobject_cast<QDropboxRequest*>(QObject::sender()));
+    logger.error("Cannot sync " + operation.entry.path + ": " + errorString);
+    done(false);
+    pump();
+    Q_UNUSED(e);
+}
+
+void QDropboxSyncEngine::onUploaded(const QVariant& metadata) {
+    QDropboxSessionUpload* upload = qobject_cast<QDropboxSessionUpload*>(QObject::sender());
+    Operation operation = m_uploads.take(upload);
+    upload->deleteLater();
+
+    QVariantMap map = metadata.toMap();
+    SyncEntry entry = operation.entry;
+    entry.rev = map.value("rev").toString();
+    m_base.insert(operation.key, entry);
+    m_remote.insert(operation.key, entry);
+    done(true);
+    pump();
+}
+
+void QDropboxSyncEngine::onUploadFailed(const QString& reason) {
+    QDropboxSessionUpload* upload = qobject_cast<QDropboxSessionUpload*>(QObject::sender());
+    Operation operation = m_uploads.take(upload);
+    upload->deleteLater();
+
+    logger.error("Cannot sync " + operation.entry.path + ": " + reason);
+    done(false);
+    pump();
+}
+
+void QDropboxSyncEngine::done(const bool& ok) {
+    m_done++;
+    if (!ok) {
+        m_failures++;
+    }
+    if (!m_saveTimer.isActive()) {
+        m_saveTimer.start();
+    }
+    emit progress(m_done, m_total);
+}
+
+void QDropboxSyncEngine::finish() {
+    m_state = Idle;
+    save();
+
+    if (m_failures) {
+        emit failed(QString::number(m_failures) + " of " + QString::number(m_total) + " operations failed");
+    } else {
+        emit synced();
+    }
+}
+
+void QDropboxSyncEngine::save() {
+    m_saveTimer.stop();
+
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out << (qint32) STATE_VERSION << m_cursor;
+    writeEntries(out, m_remote);
+    writeEntries(out, m_base);
+
+    if (!QDropboxAtomicFile::save(m_statePath, data)) {
+        logger.error("Cannot save sync state: " + m_statePath);
+    }
+}
+
+void QDropboxSyncEngine::load() {
+    QDropboxAtomicFile::recover(m_statePath);
+
+    QFile file(m_statePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream in(&file);
+    qint32 version = 0;
+    in >> version;
+    if (version != STATE_VERSION) {
+        logger.warn("Unknown sync state version: " + QString::number(version));
+        return;
+    }
+
+    in >> m_cursor;
+    readEntries(in, m_remote);
+    readEntries(in, m_base);
+    file.close();
+}
+
+void QDropboxSyncEngine::writeEntries(QDataStream& out, const QHash<QString, SyncEntry>& entries) const {
+    out << (qint32) entries.size();
+    QHash<QString, SyncEntry>::const_iterator it = entries.constBegin();
+    for (; it != entries.constEnd(); ++it) {
+        const SyncEntry& entry = it.value();
+        out << it.key() << entry.path << entry.folder << entry.size << entry.modified << entry.contentHash << entry.rev;
+    }
+}
+
+void QDropboxSyncEngine::readEntries(QDataStream& in, QHash<QString, SyncEntry>& entries) const {
+    qint32 count = 0;
+    in >> count;
+    for (int i = 0; i < count && !in.atEnd(); i++) {
+        QString key;
+        SyncEntry entry;
+        in >> key >> entry.path >> entry.folder >> entry.size >> entry.modified >> entry.contentHash >> entry.rev;
+        entries.insert(key, entry);
+    }
+}
+
+QString QDropboxSyncEngine::localFilePath(const QString& path) const {
+    return m_localPath + "/" + path;
+}
+
+QString QDropboxSyncEngine::remoteFilePath(const QString& path) const {
+    return m_remotePath + "/" + path;
+}
+
+bool QDropboxSyncEngine::same(const SyncEntry& a, const SyncEntry& b) {
+    return a.folder == b.folder && (a.folder || a.contentHash.compare(b.contentHash) == 0);
+}
+
+void QDropboxSyncEngine::addAncestors(QSet<QString>& keys, const QString& key) {
+    int i = key.lastIndexOf('/');
+    while (i > 0) {
+        keys.insert(key.left(i));
+        i = key.lastIndexOf('/', i - 1);
+    }
+}
+
+bool QDropboxSyncEngine::hasAncestor(const QSet<QString>& keys, const QString& key) {
+    int i = key.lastIndexOf('/');
+    while (i > 0) {
+        if (keys.contains(key.left(i))) {
+            return true;
+        }
+        i = key.lastIndexOf('/', i - 1);
+    }
+    return false;
+}
+
+void QDropboxSyncEngine::removeTree(QHash<QString, SyncEntry>& entries, const QString& key) {
+    entries.remove(key);
+    QString prefix = key + "/";
+    QMutableHashIterator<QString, SyncEntry> it(entries);
+    while (it.hasNext()) {
+        if (it.next().key().startsWith(prefix)) {
+            it.remove();
+        }
+    }
+}
+
+bool QDropboxSyncEngine::removeLocal(const QString& path) {
+    QFileInfo info(path);
+    if (!info.isDir() || info.isSymLink()) {
+        return QFile::remove(path) || !info.exists();
+    }
+
+    // QDir::removeRecursively() is not available before Qt 5
+    QDir dir(path);
+    foreach(QFileInfo entry, dir.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System)) {
+        if (!removeLocal(entry.absoluteFilePath())) {
+            return false;
+        }
+    }
+    return QDir().rmdir(path);
+}
+
+QString QDropboxSyncEngine::conflictedCopy(const QString& path) {
+    QString suffix = " (conflicted copy " + QDate::currentDate().toString("yyyy-MM-dd") + ")";
+    int slash = path.lastIndexOf('/');
+    int dot = path.lastIndexOf('.');
+    if (dot <= slash + 1) {
+        return path + suffix;
+    }
+    return path.left(dot) + suffix + path.mid(dot);
+}
@@ -0,0 +1,310 @@
+/*
+ * QDropboxThumbnailCache.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#include "../../include/qdropbox/QDropboxThumbnailCache.hpp"
+#include "../../include/qdropbox/QDropboxCommon.hpp"
+#include "../../include/qdropbox/QDropboxAtomicFile.hpp"
+#include <QDir>
+#include <QFile>
+#include <QDataStream>
+#include <QMap>
+#include <QSet>
+#include <QRegExp>
+#include <QDateTime>
+#include <QCryptographicHash>
+
+Logger QDropboxThumbnailCache::logger = Logger::getLogger("QDropboxThumbnailCache");
+
+#define MEMORY_CACHE_SIZE 33554432 // 32 MB
+#define DISK_CACHE_SIZE 268435456 // 256 MB
+#define INDEX_FILENAME "index"
+#define INDEX_VERSION 1
+#define SAVE_DELAY 2000
+
+QDropboxThumbnailCache::QDropboxThumbnailCache(const QString& directory, QObject* parent) : QObject(parent),
+        m_directory(directory), m_diskUsage(0), m_maxDisk(DISK_CACHE_SIZE) {
+    m_memory.setMaxCost(MEMORY_CACHE_SIZE);
+    m_saveTimer.setSingleShot(true);
+
+    bool res = QObject::connect(&m_saveTimer, SIGNAL(timeout()), this, SLOT(save()));
+    Q_ASSERT(res);
+    Q_UNUSED(res);
+
+    QDir dir(m_directory);
+    if (!dir.exists()) {
+        dir.mkpath(m_directory);
+    }
+    load();
+}
+
+QDropboxThumbnailCache::~QDropboxThumbnailCache() {
+    if (m_saveTimer.isActive()) {
+        save();
+    }
+}
+
+const QString& QDropboxThumbnailCache::getDirectory() const { return m_directory; }
+
+int QDropboxThumbnailCache::getMaxMemory() const { return m_memory.maxCost(); }
+QDropboxThumbnailCache& QDropboxThumbnailCache::setMaxMemory(const int& maxMemory) {
+    m_memory.setMaxCost(maxMemory);
+    return *this;
+}
+
+const qint64& QDropboxThumbnailCache::getMaxDisk() const { return m_maxDisk; }
+QDropboxThumbnailCache& QDropboxThumbnailCache::setMaxDisk(const qint64& maxDisk) {
+    m_maxDisk = maxDisk;
+    evictDisk();
+    return *this;
+}
+
+QString QDropboxThumbnailCache::revision(const QString& path) const {
+    return m_revs.value(path.toLower(), "");
+}
+
+QImage* QDropboxThumbnailCache::find(const QString& path, const QString& size, const QString& format) {
+    QString k = key(path, size, format);
+
+    QImage* image = m_memory.object(k);
+    if (image != 0) {
+        return new QImage(*image);
+    }
+    return 0;
+}
+
+QByteArray QDropboxThumbnailCache::findData(const QString& path, const QString& size, const QString& format) {
+    QString k = key(path, size, format);
+    if (!m_disk.contains(k)) {
+        return QByteArray();
+    }
+
+    DiskEntry& entry = m_disk[k];
+    QFile file(m_directory + "/" + entry.filename);
+    if (file.open(QIODevice::ReadOnly)) {
+        QByteArray data = file.readAll();
+        file.close();
+        if (data.size() == entry.size) {
+            entry.lastUsed = QDateTime::currentDateTime().toTime_t();
+            scheduleSave();
+            return data;
+        }
+    }
+
+    logger.warn("Broken cache entry: " + k);
+    removeDiskEntry(k);
+    scheduleSave();
+    return QByteArray();
+}
+
+void QDropboxThumbnailCache::insert(const QString& path, const QString& size, const QString& format, const QByteArray& data, const QImage& image) {
+    if (image.isNull() || data.isEmpty()) {
+        return;
+    }
+
+    QString k = key(path, size, format);
+    m_memory.insert(k, new QImage(image), qMax(1, image.byteCount()));
+    if (m_disk.contains(k)) {
+        // decoded from the disk tier, the same rev has the same payload
+        m_disk[k].lastUsed = QDateTime::currentDateTime().toTime_t();
+        scheduleSave();
+        return;
+    }
+
+    DiskEntry entry;
+    entry.path = path.toLower();
+    entry.rev = m_revs.value(entry.path, "");
+    entry.filename = QString(QCryptographicHash::hash(k.toUtf8(), QCryptographicHash::Md5).toHex());
+    entry.size = data.size();
+    entry.lastUsed = QDateTime::currentDateTime().toTime_t();
+
+    QFile file(m_directory + "/" + entry.filename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        logger.error("Cannot write cache file: " + file.fileName());
+        return;
+    }
+    file.write(data);
+    file.close();
+
+    m_disk.insert(k, entry);
+    m_keysByPath.insert(entry.path, k);
+    m_diskUsage += entry.size;
+
+    evictDisk();
+    scheduleSave();
+}
+
+void QDropboxThumbnailCache::remove(const QString& path, const QString& size, const QString& format) {
+    removeDiskEntry(key(path, size, format));
+    scheduleSave();
+}
+
+void QDropboxThumbnailCache::invalidate(const QString& path) {
+    QString pathLower = path.toLower();
+    QString prefix = pathLower + "/";
+    foreach(QString p, m_keysByPath.uniqueKeys()) {
+        if (p.compare(pathLower) == 0 || p.startsWith(prefix)) {
+            foreach(QString k, m_keysByPath.values(p)) {
+                removeDiskEntry(k);
+            }
+            m_keysByPath.remove(p);
+        }
+    }
+    scheduleSave();
+}
+
+void QDropboxThumbnailCache::clear() {
+    foreach(QString k, m_disk.keys()) {
+        removeDiskEntry(k);
+    }
+    m_memory.clear();
+    m_keysByPath.clear();
+    m_revs.clear();
+    scheduleSave();
+}
+
+void QDropboxThumbnailCache::update(const QList<QDropboxFile*>& files) {
+    foreach(QDropboxFile* file, files) {
+        QString pathLower = file->getPathLower();
+        if (file->getTag().compare(DELETED_TAG) == 0) {
+            // a deleted folder takes everything below it along
+            invalidate(pathLower);
+            QString prefix = pathLower + "/";
+            QMutableHashIterator<QString, QString> it(m_revs);
+            while (it.hasNext()) {
+                QString p = it.next().key();
+                if (p.compare(pathLower) == 0 || p.startsWith(prefix)) {
+                    it.remove();
+                }
+            }
+        } else if (file->isFile()) {
+            QString rev = file->getRev();
+            foreach(QString k, m_keysByPath.values(pathLower)) {
+                if (m_disk.value(k).rev.compare(rev) != 0) {
+                    removeDiskEntry(k);
+                    scheduleSave();
+                }
+            }
+            m_revs.insert(pathLower, rev);
+        }
+    }
+}
+
+void QDropboxThumbnailCache::save() {
+    m_saveTimer.stop();
+
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out << (qint32) INDEX_VERSION << (qint32) m_disk.size();
+    QHash<QString, DiskEntry>::const_iterator it = m_disk.constBegin();
+    for (; it != m_disk.constEnd(); ++it) {
+        const DiskEntry& entry = it.value();
+        out << it.key() << entry.path << entry.rev << entry.filename << entry.size << (quint32) entry.lastUsed;
+    }
+
+    QString indexPath = m_directory + "/" + INDEX_FILENAME;
+    if (!QDropboxAtomicFile::save(indexPath, data)) {
+        logger.error("Cannot save cache index: " + indexPath);
+    }
+}
+
+QString QDropboxThumbnailCache::key(const QString& path, const QString& size, const QString& format) const {
+    QString pathLower = path.toLower();
+    return QString(pathLower).append("|").append(m_revs.value(pathLower, "")).append("|").append(size).append("|").append(format);
+}
+
+void QDropboxThumbnailCache::load() {
+    QString indexPath = m_directory + "/" + INDEX_FILENAME;
+    QDropboxAtomicFile::recover(indexPath);
+
+    QFile file(indexPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        sweep();
+        return;
+    }
+
+    QDataStream in(&file);
+    qint32 version = 0;
+    qint32 count = 0;
+    in >> version >> count;
+    if (version != INDEX_VERSION) {
+        logger.warn("Unknown cache index version: " + QString::number(version));
+        sweep();
+        return;
+    }
+
+    for (int i = 0; i < count && !in.atEnd(); i++) {
+        QString k;
+        DiskEntry entry;
+        quint32 lastUsed = 0;
+        in >> k >> entry.path >> entry.rev >> entry.filename >> entry.size >> lastUsed;
+        entry.lastUsed = lastUsed;
+
+        m_disk.insert(k, entry);
+        m_keysByPath.insert(entry.path, k);
+        m_diskUsage += entry.size;
+        if (!entry.rev.isEmpty()) {
+            m_revs.insert(entry.path, entry.rev);
+        }
+    }
+    file.close();
+    sweep();
+}
+
+void QDropboxThumbnailCache::sweep() {
+    // files the index does not know, left behind by a lost or older index, are outside the disk bound otherwise
+    QSet<QString> known;
+    foreach(DiskEntry entry, m_disk.values()) {
+        known.insert(entry.filename);
+    }
+
+    QRegExp cacheFile("[0-9a-f]{32}");
+    QDir dir(m_directory);
+    foreach(QString filename, dir.entryList(QDir::Files)) {
+        if (cacheFile.exactMatch(filename) && !known.contains(filename)) {
+            logger.debug("Orphaned cache file: " + filename);
+            QFile::remove(dir.filePath(filename));
+        }
+    }
+}
+
+void QDropboxThumbnailCache::removeDiskEntry(const QString& key) {
+    m_memory.remove(key);
+    if (!m_disk.contains(key)) {
+        return;
+    }
+
+    DiskEntry entry = m_disk.take(key);
+    QFile::remove(m_directory + "/" + entry.filename);
+    m_keysByPath.remove(entry.path, key);
+    m_diskUsage -= entry.size;
+}
+
+void QDropboxThumbnailCache::evictDisk() {
+    if (m_diskUsage <= m_maxDisk) {
+        return;
+    }
+
+    QMultiMap<uint, QString> byAge;
+    QHash<QString, DiskEntry>::const_iterator it = m_disk.constBegin();
+    for (; it != m_disk.constEnd(); ++it) {
+        byAge.insert(it.value().lastUsed, it.key());
+    }
+
+    qint64 target = m_maxDisk - m_maxDisk / 10;
+    QMultiMap<uint, QString>::const_iterator old = byAge.constBegin();
+    while (m_diskUsage > target && old != byAge.constEnd()) {
+        removeDiskEntry(old.value());
+        ++old;
+    }
+    scheduleSave();
+}
+
+void QDropboxThumbnailCache::scheduleSave() {
+    if (!m_saveTimer.isActive()) {
+        m_saveTimer.start(SAVE_DELAY);
+    }
+}
@@ -0,0 +1,138 @@
+/*
+ * QDropboxThumbnailDecoder.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#include "../../include/qdropbox/QDropboxThumbnailDecoder.hpp"
+#include "../qjson/parser.h"
+#include <QVariantMap>
+#include <QBuffer>
+#include <QMutexLocker>
+#include <QtGui/QImageReader>
+
+#define POOL_SIZE 64
+
+Logger QDropboxThumbnailDecoder::logger = Logger::getLogger("QDropboxThumbnailDecoder");
+
+QMutex QDropboxThumbnailDecoder::m_poolMutex;
+QList<QImage> QDropboxThumbnailDecoder::m_pool;
+
+QDropboxThumbnailDecoder::QDropboxThumbnailDecoder(const QByteArray& data, const QVariantList& entries, const Mode& mode, QObject* parent) : QObject(parent),
+        m_data(data), m_entries(entries), m_mode(mode) {
+    setAutoDelete(false);
+}
+
+QDropboxThumbnailDecoder::~QDropboxThumbnailDecoder() {}
+
+void QDropboxThumbnailDecoder::run() {
+    if (m_mode == Single) {
+        if (m_entries.size()) {
+            decode(m_entries.first().toMap(), m_data);
+        }
+        m_data.clear();
+        emit decoded();
+        return;
+    }
+
+    bool res = false;
+    QVariant data = QJson::Parser().parse(m_data, &res);
+    m_data.clear();
+
+    if (res) {
+        QVariantList entries = data.toMap().value("entries").toList();
+        for (int i = 0; i < entries.size() && i < m_entries.size(); i++) {
+            QVariantMap entry = entries.at(i).toMap();
+            QVariantMap request = m_entries.at(i).toMap();
+            if (entry.value(".tag").toString().compare("success") != 0) {
+                QVariantMap failure = entry.value("failure").toMap();
+                fail(request, "Thumbnail failed: " + failure.value(".tag").toString());
+                continue;
+            }
+            decode(request, QByteArray::fromBase64(entry.value("thumbnail").toByteArray()));
+        }
+        for (int i = entries.size(); i < m_entries.size(); i++) {
+            fail(m_entries.at(i).toMap(), "Thumbnail missing from batch response");
+        }
+    } else {
+        logger.error("Cannot parse thumbnail batch response");
+        foreach(QVariant request, m_entries) {
+            fail(request.toMap(), "Cannot parse thumbnail batch response");
+        }
+    }
+
+    emit decoded();
+}
+
+const QSize& QDropboxThumbnailDecoder::getScaledSize() const { return m_scaledSize; }
+QDropboxThumbnailDecoder& QDropboxThumbnailDecoder::setScaledSize(const QSize& scaledSize) {
+    m_scaledSize = scaledSize;
+    return *this;
+}
+
+const QList<DecodedThumbnail>& QDropboxThumbnailDecoder::getThumbnails() const { return m_thumbnails; }
+
+void QDropboxThumbnailDecoder::recycle(QImage* image) {
+    // a buffer still shared would be copied on the next decode into it, so only a sole owner gives it back
+    if (image != 0 && !image->isNull() && image->isDetached()) {
+        QMutexLocker locker(&m_poolMutex);
+        if (m_pool.size() < POOL_SIZE) {
+            m_pool.append(*image);
+        }
+    }
+    delete image;
+}
+
+void QDropboxThumbnailDecoder::decode(const QVariantMap& entry, const QByteArray& data) {
+    DecodedThumbnail thumbnail;
+    thumbnail.key = entry.value("key").toString();
+    thumbnail.path = entry.value("path").toString();
+    thumbnail.size = entry.value("size").toString();
+    thumbnail.format = entry.value("format").toString();
+    thumbnail.data = data;
+
+    QBuffer buffer(&thumbnail.data);
+    buffer.open(QIODevice::ReadOnly);
+    QImageReader reader(&buffer);
+
+    QSize size = reader.size();
+    if (m_scaledSize.isValid() && size.isValid()) {
+        size.scale(m_scaledSize, Qt::KeepAspectRatio);
+        reader.setScaledSize(size);
+    }
+
+    thumbnail.image = acquire(size);
+    if (!reader.read(&thumbnail.image)) {
+        fail(entry, "Cannot decode thumbnail: " + reader.errorString());
+        return;
+    }
+    m_thumbnails.append(thumbnail);
+}
+
+void QDropboxThumbnailDecoder::fail(const QVariantMap& entry, const QString& errorString) {
+    logger.warn(errorString + ": " + entry.value("path").toString());
+
+    DecodedThumbnail thumbnail;
+    thumbnail.key = entry.value("key").toString();
+    thumbnail.path = entry.value("path").toString();
+    thumbnail.size = entry.value("size").toString();
+    thumbnail.format = entry.value("format").toString();
+    thumbnail.errorString = errorString;
+    m_thumbnails.append(thumbnail);
+}
+
+QImage QDropboxThumbnailDecoder::acquire(const QSize& size) {
+    QMutexLocker locker(&m_poolMutex);
+    for (int i = 0; i < m_pool.size(); i++) {
+        // only buffers nobody else references can be written in place by QImageReader
+        if (m_pool.at(i).size() == size) {
+            QImage image = m_pool.takeAt(i);
+            if (image.isDetached()) {
+                return image;
+            }
+            i--;
+        }
+    }
+    return QImage();
+}
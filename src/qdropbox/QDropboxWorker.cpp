@@ -0,0 +1,132 @@
+/*
+ * QDropboxWorker.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#include "../../include/qdropbox/QDropboxWorker.hpp"
+#include <QFile>
+#include <QSize>
+
+QDropboxWorker::QDropboxWorker(QObject* parent) : QObject(parent), m_pDropbox(0) {}
+
+QDropboxWorker::~QDropboxWorker() {}
+
+QDropbox* QDropboxWorker::getDropbox() const { return m_pDropbox; }
+
+void QDropboxWorker::start(const QVariantMap& configuration) {
+    if (m_pDropbox != 0) {
+        return;
+    }
+
+    m_pDropbox = new QDropbox(this);
+    configure(configuration);
+
+    bool res = QObject::connect(m_pDropbox, SIGNAL(listFolderLoaded(const QString&, QList<QDropboxFile*>&, const QString&, const bool&)),
+            this, SLOT(onListFolderLoaded(const QString&, QList<QDropboxFile*>&, const QString&, const bool&)));
+    Q_ASSERT(res);
+    res = QObject::connect(m_pDropbox, SIGNAL(listFolderContinueLoaded(QList<QDropboxFile*>&, const QString&, const QString&, const bool&)),
+            this, SLOT(onListFolderContinueLoaded(QList<QDropboxFile*>&, const QString&, const QString&, const bool&)));
+    Q_ASSERT(res);
+    Q_UNUSED(res);
+}
+
+void QDropboxWorker::stop() {
+    // timers and replies of the QDropbox have to be torn down on this thread
+    delete m_pDropbox;
+    m_pDropbox = 0;
+}
+
+void QDropboxWorker::configure(const QVariantMap& configuration) {
+    if (m_pDropbox == 0) {
+        return;
+    }
+
+    if (configuration.contains("accessToken")) {
+        m_pDropbox->setAccessToken(configuration.value("accessToken").toString());
+    }
+    if (configuration.contains("url")) {
+        m_pDropbox->setUrl(configuration.value("url").toString());
+    }
+    if (configuration.contains("version")) {
+        m_pDropbox->setVersion(configuration.value("version").toInt());
+    }
+    if (configuration.contains("downloadsFolder")) {
+        m_pDropbox->setDownloadsFolder(configuration.value("downloadsFolder").toString());
+    }
+    if (configuration.contains("coalesceRequests")) {
+        m_pDropbox->setCoalesceRequests(configuration.value("coalesceRequests").toBool());
+    }
+    if (configuration.contains("thumbnailScaledSize")) {
+        m_pDropbox->setThumbnailScaledSize(configuration.value("thumbnailScaledSize").toSize());
+    }
+    if (configuration.contains("http2Allowed")) {
+        m_pDropbox->setHttp2Allowed(configuration.value("http2Allowed").toBool());
+    }
+    if (configuration.contains("maxConnectionsPerHost")) {
+        m_pDropbox->setMaxConnectionsPerHost(configuration.value("maxConnectionsPerHost").toInt());
+    }
+    if (configuration.contains("requestTimeout")) {
+        m_pDropbox->setRequestTimeout(configuration.value("requestTimeout").toInt());
+    }
+    if (configuration.contains("stallTimeout")) {
+        m_pDropbox->setStallTimeout(configuration.value("stallTimeout").toInt());
+    }
+    if (configuration.contains("maxRetries")) {
+        m_pDropbox->setMaxRetries(configuration.value("maxRetries").toInt());
+    }
+}
+
+void QDropboxWorker::getMetadata(const QString& path, const bool& includeMediaInfo) {
+    m_pDropbox->getMetadata(path, includeMediaInfo);
+}
+
+void QDropboxWorker::listFolder(const QString& path, const bool& includeMediaInfo, const bool& recursive) {
+    m_pDropbox->listFolder(path, includeMediaInfo, recursive);
+}
+
+void QDropboxWorker::listFolderContinue(const QString& cursor) {
+    m_pDropbox->listFolderContinue(cursor);
+}
+
+void QDropboxWorker::getThumbnail(const QString& path, const QString& size, const QString& format) {
+    m_pDropbox->getThumbnail(path, size, format);
+}
+
+void QDropboxWorker::getTemporaryLink(const QString& path) {
+    m_pDropbox->getTemporaryLink(path);
+}
+
+void QDropboxWorker::download(const QString& path, const QString& rev) {
+    m_pDropbox->download(path, rev);
+}
+
+void QDropboxWorker::upload(const QString& localPath, const QString& remotePath, const QString& mode) {
+    // the QDropbox takes the file over, also when it cannot be opened
+    m_pDropbox->upload(new QFile(localPath), remotePath, mode);
+}
+
+void QDropboxWorker::createFolder(const QString& path, const bool& autorename) {
+    m_pDropbox->createFolder(path, autorename);
+}
+
+void QDropboxWorker::deleteFile(const QString& path) {
+    m_pDropbox->deleteFile(path);
+}
+
+void QDropboxWorker::move(const QString& fromPath, const QString& toPath) {
+    m_pDropbox->move(fromPath, toPath);
+}
+
+void QDropboxWorker::copy(const QString& fromPath, const QString& toPath) {
+    m_pDropbox->copy(fromPath, toPath);
+}
+
+void QDropboxWorker::onListFolderLoaded(const QString& path, QList<QDropboxFile*>& files, const QString& cursor, const bool& hasMore) {
+    emit listFolderLoaded(path, files, cursor, hasMore);
+}
+
+void QDropboxWorker::onListFolderContinueLoaded(QList<QDropboxFile*>& files, const QString& prevCursor, const QString& cursor, const bool& hasMore) {
+    emit listFolderContinueLoaded(files, prevCursor, cursor, hasMore);
+}
@@ -0,0 +1,298 @@
+/*
+ * QDropboxZipExtractor.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: doctorrokter
+ */
+
+#include "../../include/qdropbox/QDropboxZipExtractor.hpp"
+#include <QDir>
+#include <QFileInfo>
+#include <string.h>
+#include <zlib.h>
+
+#define LOCAL_HEADER_SIGNATURE 0x04034b50
+#define CENTRAL_HEADER_SIGNATURE 0x02014b50
+#define END_SIGNATURE 0x06054b50
+#define ZIP64_END_SIGNATURE 0x06064b50
+#define DESCRIPTOR_SIGNATURE 0x08074b50
+#define LOCAL_HEADER_SIZE 30
+#define FLAG_DESCRIPTOR 0x0008
+#define FLAG_UTF8 0x0800
+#define METHOD_STORED 0
+#define METHOD_DEFLATED 8
+#define ZIP64_EXTRA 0x0001
+#define OUTPUT_SIZE 65536
+
+static quint16 le16(const char* p) {
+    const uchar* u = reinterpret_cast<const uchar*>(p);
+    return (quint16) (u[0] | (u[1] << 8));
+}
+
+static quint32 le32(const char* p) {
+    return (quint32) le16(p) | ((quint32) le16(p + 2) << 16);
+}
+
+static quint64 le64(const char* p) {
+    return (quint64) le32(p) | ((quint64) le32(p + 4) << 32);
+}
+
+QDropboxZipExtractor::QDropboxZipExtractor(const QString& directory, QObject* parent) : QIODevice(parent),
+        m_directory(QDir(directory).absolutePath()), m_stripComponents(0), m_extracted(0), m_state(Header), m_pFile(0),
+        m_pStream(new z_stream_s()), m_flags(0), m_method(0), m_remaining(0), m_zip64(false) {
+    memset(m_pStream, 0, sizeof(z_stream_s));
+    // raw deflate data, zip entries have no zlib header
+    inflateInit2(m_pStream, -MAX_WBITS);
+}
+
+QDropboxZipExtractor::~QDropboxZipExtractor() {
+    closeEntry();
+    inflateEnd(m_pStream);
+    delete m_pStream;
+}
+
+const QString& QDropboxZipExtractor::getDirectory() const { return m_directory; }
+
+const int& QDropboxZipExtractor::getStripComponents() const { return m_stripComponents; }
+QDropboxZipExtractor& QDropboxZipExtractor::setStripComponents(const int& stripComponents) {
+    m_stripComponents = stripComponents;
+    return *this;
+}
+
+const QStringList& QDropboxZipExtractor::getFiles() const { return m_files; }
+
+const qint64& QDropboxZipExtractor::getExtracted() const { return m_extracted; }
+
+bool QDropboxZipExtractor::isComplete() const {
+    return m_state == Done;
+}
+
+bool QDropboxZipExtractor::isSequential() const {
+    return true;
+}
+
+void QDropboxZipExtractor::close() {
+    if (m_pFile != 0) {
+        // the archive ended in the middle of an entry
+        m_pFile->remove();
+        delete m_pFile;
+        m_pFile = 0;
+    }
+    QIODevice::close();
+}
+
+qint64 QDropboxZipExtractor::readData(char* data, qint64 maxSize) {
+    Q_UNUSED(data);
+    Q_UNUSED(maxSize);
+    return -1;
+}
+
+qint64 QDropboxZipExtractor::writeData(const char* data, qint64 size) {
+    if (m_state == Failed) {
+        return -1;
+    }
+    if (m_state == Done) {
+        return size;
+    }
+
+    m_buffer.append(data, (int) size);
+    bool next = true;
+    while (next) {
+        switch (m_state) {
+            case Header:
+                next = readHeader();
+                break;
+            case Data:
+                next = m_method == METHOD_DEFLATED ? inflateData() : copyData();
+                break;
+            case Descriptor:
+                next = readDescriptor();
+                break;
+            default:
+                next = false;
+                break;
+        }
+    }
+
+    if (m_state == Failed) {
+        return -1;
+    }
+    if (m_state == Done) {
+        m_buffer.clear();
+    }
+    return size;
+}
+
+bool QDropboxZipExtractor::readHeader() {
+    if (m_buffer.size() < 4) {
+        return false;
+    }
+
+    quint32 signature = le32(m_buffer.constData());
+    if (signature == CENTRAL_HEADER_SIGNATURE || signature == END_SIGNATURE || signature == ZIP64_END_SIGNATURE) {
+        m_state = Done;
+        return false;
+    }
+    if (signature != LOCAL_HEADER_SIGNATURE) {
+        fail("Not a zip archive");
+        return false;
+    }
+    if (m_buffer.size() < LOCAL_HEADER_SIZE) {
+        return false;
+    }
+
+    const char* p = m_buffer.constData();
+    int nameLength = le16(p + 26);
+    int extraLength = le16(p + 28);
+    if (m_buffer.size() < LOCAL_HEADER_SIZE + nameLength + extraLength) {
+        return false;
+    }
+
+    m_flags = le16(p + 6);
+    m_method = le16(p + 8);
+    m_remaining = le32(p + 18);
+    QByteArray rawName(p + LOCAL_HEADER_SIZE, nameLength);
+    QString name = (m_flags & FLAG_UTF8) ? QString::fromUtf8(rawName) : QString::fromLatin1(rawName);
+
+    m_zip64 = false;
+    const char* extra = p + LOCAL_HEADER_SIZE + nameLength;
+    for (int i = 0; i + 4 <= extraLength;) {
+        quint16 id = le16(extra + i);
+        quint16 size = le16(extra + i + 2);
+        if (id == ZIP64_EXTRA) {
+            m_zip64 = true;
+            if (m_remaining == 0xFFFFFFFF && size >= 16 && i + 20 <= extraLength) {
+                m_remaining = le64(extra + i + 12);
+            }
+        }
+        i += 4 + size;
+    }
+    m_buffer.remove(0, LOCAL_HEADER_SIZE + nameLength + extraLength);
+
+    bool folder = name.endsWith("/");
+    if (m_method != METHOD_STORED && m_method != METHOD_DEFLATED) {
+        fail("Unsupported compression method of " + name);
+        return false;
+    }
+    if (m_method == METHOD_STORED && (m_flags & FLAG_DESCRIPTOR) && !folder) {
+        fail("Size of " + name + " is unknown");
+        return false;
+    }
+    if (folder) {
+        m_remaining = 0;
+    }
+
+    QString path = target(name);
+    if (!path.isEmpty() && folder) {
+        QDir().mkpath(path);
+    } else if (!path.isEmpty()) {
+        QDir().mkpath(QFileInfo(path).absolutePath());
+        m_pFile = new QFile(path);
+        if (!m_pFile->open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            delete m_pFile;
+            m_pFile = 0;
+            fail("Cannot open file: " + path);
+            return false;
+        }
+        m_current = QDir(m_directory).relativeFilePath(path);
+    }
+
+    if (m_method == METHOD_DEFLATED) {
+        inflateReset(m_pStream);
+    }
+    m_state = Data;
+    return true;
+}
+
+bool QDropboxZipExtractor::inflateData() {
+    if (m_buffer.isEmpty()) {
+        return false;
+    }
+
+    char out[OUTPUT_SIZE];
+    m_pStream->next_in = reinterpret_cast<Bytef*>(m_buffer.data());
+    m_pStream->avail_in = m_buffer.size();
+    int res = Z_OK;
+    do {
+        m_pStream->next_out = reinterpret_cast<Bytef*>(out);
+        m_pStream->avail_out = OUTPUT_SIZE;
+        res = inflate(m_pStream, Z_NO_FLUSH);
+        if (res != Z_OK && res != Z_STREAM_END && res != Z_BUF_ERROR) {
+            fail("Corrupt archive entry: " + m_current);
+            return false;
+        }
+
+        int size = OUTPUT_SIZE - m_pStream->avail_out;
+        if (size > 0 && m_pFile != 0) {
+            m_pFile->write(out, size);
+        }
+        m_extracted += size;
+    } while (res == Z_OK && (m_pStream->avail_in > 0 || m_pStream->avail_out == 0));
+    m_buffer.remove(0, m_buffer.size() - m_pStream->avail_in);
+
+    if (res != Z_STREAM_END) {
+        return false;
+    }
+    closeEntry();
+    m_state = (m_flags & FLAG_DESCRIPTOR) ? Descriptor : Header;
+    return true;
+}
+
+bool QDropboxZipExtractor::copyData() {
+    int size = (int) qMin((qint64) m_buffer.size(), m_remaining);
+    if (size > 0 && m_pFile != 0) {
+        m_pFile->write(m_buffer.constData(), size);
+    }
+    m_buffer.remove(0, size);
+    m_remaining -= size;
+    m_extracted += size;
+    if (m_remaining > 0) {
+        return false;
+    }
+
+    closeEntry();
+    m_state = (m_flags & FLAG_DESCRIPTOR) ? Descriptor : Header;
+    return true;
+}
+
+bool QDropboxZipExtractor::readDescriptor() {
+    // crc and both sizes, optionally preceded by a signature
+    if (m_buffer.size() < 4) {
+        return false;
+    }
+    int size = (m_zip64 ? 20 : 12) + (le32(m_buffer.constData()) == DESCRIPTOR_SIGNATURE ? 4 : 0);
+    if (m_buffer.size() < size) {
+        return false;
+    }
+
+    m_buffer.remove(0, size);
+    m_state = Header;
+    return true;
+}
+
+void QDropboxZipExtractor::closeEntry() {
+    if (m_pFile == 0) {
+        return;
+    }
+
+    m_pFile->close();
+    delete m_pFile;
+    m_pFile = 0;
+    m_files.append(m_current);
+}
+
+void QDropboxZipExtractor::fail(const QString& reason) {
+    m_state = Failed;
+    setErrorString(reason);
+}
+
+QString QDropboxZipExtractor::target(const QString& name) const {
+    QStringList parts = name.split("/", QString::SkipEmptyParts);
+    if (parts.contains("..") || parts.contains(".")) {
+        return "";
+    }
+    for (int i = 0; i < m_stripComponents && !parts.isEmpty(); i++) {
+        parts.removeFirst();
+    }
+    return parts.isEmpty() ? QString("") : m_directory + "/" + parts.join("/");
+}